@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "animation.h"
+#include "ansi-esc.h"
+#include "cell-diff.h"
+#include "edit-buffer.h"
+#include "error.h"
+
+/*
+ *	Going to a keyframe costs a copy of the canvas, about as much as
+ *	applying an eighth of its cells as changes.  A keyframe is taken
+ *	each time that many changes were recorded since the last one, so
+ *	a jump anywhere applies at most that many.
+ */
+#define ANIM_KEYFRAME_SHARE 8
+
+static unsigned long keyframe_cost(struct anim * a)
+{
+	return a->canvas->width * a->canvas->height / ANIM_KEYFRAME_SHARE;
+}
+
+static void add_frame(struct anim * a, long offset, unsigned long x,
+		      unsigned long y)
+{
+	if (a->nr_frames == a->max_frames) {
+		a->max_frames = a->max_frames ? a->max_frames * 2 : 1024;
+		a->frames = realloc(a->frames,
+				    a->max_frames * sizeof(*a->frames));
+		if (!a->frames)
+			error("Could not allocate memory for frames.");
+	}
+
+	struct anim_frame * frame = &a->frames[a->nr_frames++];
+	frame->offset = offset;
+	frame->changes = a->nr_changes;
+	frame->cursor_x = x;
+	frame->cursor_y = y;
+}
+
+static void add_change(struct anim * a, unsigned long cell,
+		       unsigned int before, unsigned int after)
+{
+	if (a->nr_changes == a->max_changes) {
+		a->max_changes = a->max_changes ? a->max_changes * 2 : 4096;
+		a->changes = realloc(a->changes,
+				     a->max_changes * sizeof(*a->changes));
+		if (!a->changes)
+			error("Could not allocate memory for changes.");
+	}
+
+	struct anim_change * change = &a->changes[a->nr_changes++];
+	change->cell = cell;
+	change->before = before;
+	change->after = after;
+}
+
+/* Of the canvas at the last frame.  */
+static void add_keyframe(struct anim * a)
+{
+	struct edit_buffer * canvas = a->canvas;
+	unsigned long size = canvas->width * canvas->height
+			     * sizeof(*canvas->buffer);
+
+	if (a->nr_keyframes == a->max_keyframes) {
+		a->max_keyframes = a->max_keyframes ? a->max_keyframes * 2 : 16;
+		a->keyframes = realloc(a->keyframes, a->max_keyframes
+				       * sizeof(*a->keyframes));
+		if (!a->keyframes)
+			error("Could not allocate memory for keyframes.");
+	}
+
+	struct anim_keyframe * key = &a->keyframes[a->nr_keyframes++];
+	key->frame = a->nr_frames - 1;
+	key->max_height = canvas->max_height;
+	key->cells = malloc(size);
+	if (!key->cells)
+		error("Could not allocate memory for keyframe.");
+	memcpy(key->cells, canvas->buffer, size);
+}
+
+struct anim * anim_open(FILE * input, unsigned long width,
+			unsigned long height)
+{
+	struct anim * a = calloc(1, sizeof(*a));
+	unsigned long from, to;
+
+	if (!a)
+		error("Could not allocate memory for animation.");
+
+	a->input = input;
+	fseek(input, 0, SEEK_END);
+	a->size = ftell(input);
+	rewind(input);
+
+	a->parsed = edit_buffer_create(width, height);
+	edit_buffer_clear(a->parsed);
+	edit_buffer_take_changes(a->parsed, &from, &to);
+	a->canvas = edit_buffer_create(width, height);
+	edit_buffer_clear(a->canvas);
+	a->stream = ans_stream_open(input, a->parsed);
+
+	add_frame(a, 0, 0, 0);
+	add_keyframe(a);
+	return a;
+}
+
+void anim_release(struct anim * a)
+{
+	unsigned long i;
+
+	for (i = 0; i < a->nr_keyframes; i++)
+		free(a->keyframes[i].cells);
+	free(a->keyframes);
+	free(a->changes);
+	free(a->frames);
+	ans_stream_close(a->stream);
+	edit_buffer_release(a->canvas);
+	edit_buffer_release(a->parsed);
+	free(a);
+}
+
+/*
+ *	Read the file on up to byte end as one more frame and show it.
+ *	The cells it changed are found by comparing the rows the reader
+ *	wrote to with the canvas at the frame before.  Returns false if
+ *	there was nothing more to read.
+ */
+bool anim_read(struct anim * a, long end)
+{
+	struct edit_buffer * canvas = a->canvas;
+	unsigned int * before = canvas->buffer, * after = a->parsed->buffer;
+	unsigned long first = a->nr_changes, from, to, i, n, x, y;
+	long offset;
+
+	if (a->ended)
+		return false;
+
+	anim_seek(a, a->nr_frames - 1);
+	if (!ans_stream_read(a->stream, end))
+		a->ended = true;
+
+	if (edit_buffer_take_changes(a->parsed, &from, &to)) {
+		n = to * canvas->width;
+		for (i = from * canvas->width; i < n; i++) {
+			i = cell_diff_first(before, after, i, n);
+			if (i == n)
+				break;
+
+			add_change(a, i, before[i], after[i]);
+			edit_buffer_put(canvas, i % canvas->width,
+					i / canvas->width, after[i]);
+		}
+	}
+
+	offset = ftell(a->input);
+	if (offset == a->frames[a->nr_frames - 1].offset
+	    && a->nr_changes == first)
+		return false;
+
+	ans_stream_cursor(a->stream, &x, &y);
+	add_frame(a, offset, x, y);
+	a->current = a->nr_frames - 1;
+
+	struct anim_keyframe * key = &a->keyframes[a->nr_keyframes - 1];
+	if (a->nr_changes - a->frames[key->frame].changes >= keyframe_cost(a))
+		add_keyframe(a);
+	return true;
+}
+
+/* The last keyframe at or before frame.  */
+static struct anim_keyframe * keyframe_before(struct anim * a,
+					      unsigned long frame)
+{
+	unsigned long lo = 0, hi = a->nr_keyframes;
+
+	while (hi - lo > 1) {
+		unsigned long mid = (lo + hi) / 2;
+
+		if (a->keyframes[mid].frame <= frame)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return &a->keyframes[lo];
+}
+
+/* Show a frame read before, from the current one or a keyframe,
+   whichever takes fewer changes.  */
+void anim_seek(struct anim * a, unsigned long frame)
+{
+	struct edit_buffer * canvas = a->canvas;
+	struct anim_keyframe * key;
+	unsigned long from, to, direct;
+
+	if (frame >= a->nr_frames)
+		frame = a->nr_frames - 1;
+
+	from = a->frames[a->current].changes;
+	to = a->frames[frame].changes;
+	direct = to > from ? to - from : from - to;
+
+	key = keyframe_before(a, frame);
+	if (to - a->frames[key->frame].changes + keyframe_cost(a) < direct) {
+		memcpy(canvas->buffer, key->cells, canvas->width
+		       * canvas->height * sizeof(*canvas->buffer));
+		canvas->max_height = key->max_height;
+		canvas->changed_from = 0;
+		canvas->changed_to = canvas->height;
+		from = a->frames[key->frame].changes;
+	}
+
+	for (; from < to; from++) {
+		struct anim_change * change = &a->changes[from];
+
+		edit_buffer_put(canvas, change->cell % canvas->width,
+				change->cell / canvas->width, change->after);
+	}
+	for (; from > to; from--) {
+		struct anim_change * change = &a->changes[from - 1];
+
+		edit_buffer_put(canvas, change->cell % canvas->width,
+				change->cell / canvas->width, change->before);
+	}
+
+	a->current = frame;
+}
+
+/* The last frame read that ends at or before byte offset.  */
+unsigned long anim_frame_at(struct anim * a, long offset)
+{
+	unsigned long lo = 0, hi = a->nr_frames;
+
+	while (hi - lo > 1) {
+		unsigned long mid = (lo + hi) / 2;
+
+		if (a->frames[mid].offset <= offset)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
+}
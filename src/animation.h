@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _ANIMATION_H
+#define _ANIMATION_H 1
+
+#include <stdbool.h>
+#include <stdio.h>
+
+struct ans_stream;
+struct edit_buffer;
+
+/*
+ *	An animation is an ANSI file played back as frames, each the bytes
+ *	that came in during one tick.  Frames are recorded as they are
+ *	first read, as the cells they change with their values before and
+ *	after, so the canvas can be moved to any frame read so far, back
+ *	or forward, by applying the changes in between.  A keyframe with
+ *	the whole canvas is kept whenever enough changes pile up, which
+ *	bounds the cost of a long jump.
+ */
+
+struct anim_change {
+	unsigned int cell;		/* index into the canvas */
+	unsigned int before;
+	unsigned int after;
+};
+
+struct anim_frame {
+	long offset;			/* bytes read by its end */
+	unsigned long changes;		/* changes made by its end */
+	unsigned long cursor_x;
+	unsigned long cursor_y;
+};
+
+struct anim_keyframe {
+	unsigned long frame;
+	unsigned long max_height;
+	unsigned int * cells;
+};
+
+struct anim {
+	FILE * input;
+	long size;			/* of the file */
+	struct ans_stream * stream;
+	struct edit_buffer * parsed;	/* the file as far as it was read */
+	struct edit_buffer * canvas;	/* at frame current */
+	unsigned long current;
+	bool ended;			/* all of the file was read */
+
+	unsigned long nr_frames;
+	unsigned long max_frames;
+	struct anim_frame * frames;
+
+	unsigned long nr_changes;
+	unsigned long max_changes;
+	struct anim_change * changes;
+
+	unsigned long nr_keyframes;
+	unsigned long max_keyframes;
+	struct anim_keyframe * keyframes;
+};
+
+struct anim * anim_open(FILE *, unsigned long, unsigned long);
+void anim_release(struct anim *);
+bool anim_read(struct anim *, long);
+void anim_seek(struct anim *, unsigned long);
+unsigned long anim_frame_at(struct anim *, long);
+
+#endif
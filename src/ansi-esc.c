@@ -18,11 +18,15 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include "ansi-esc.h"
 #include "colors.h"
 #include "error.h"
 #include "edit-buffer.h"
@@ -47,6 +51,32 @@ struct ans_escape_seq_ctx {
 #define DEFAULT_BG_COLOR 0x00
 #define DEFAULT_FG_COLOR 0x07
 
+static const struct ans_escape_seq_ctx initial_ctx = {
+	.current_line = 0,
+	.current_col  = 0,
+	.saved_line   = 0,
+	.saved_col    = 0,
+	.bold         = DEFAULT_BOLD,
+	.fg_color     = DEFAULT_FG_COLOR,
+	.bg_color     = DEFAULT_BG_COLOR
+};
+
+/*
+ *	Reading puts the cells of file rows first_row onwards in the
+ *	buffer, dropping the ones that don't fit.  Without a buffer only
+ *	the state is followed.
+ */
+struct ans_reader {
+	FILE * input;
+	struct edit_buffer * buf;
+	unsigned long first_row;
+	unsigned long nr_rows;		/* rows written to so far */
+	unsigned long low_row;		/* lowest row written to */
+	struct ans_escape_seq_ctx ctx;
+};
+
+#define MAX_COL 80
+
 static void __ans_move_cursor(struct ans_escape_seq_ctx * ctx,
 			      unsigned long line, unsigned long col)
 {
@@ -54,16 +84,25 @@ static void __ans_move_cursor(struct ans_escape_seq_ctx * ctx,
 	ctx->current_col  = col;
 }
 
+/* Either number may be left out and means 1.  */
 static void ans_move_cursor(struct ans_escape_seq_ctx * ctx,
 			    char * params, unsigned long len)
 {
-	unsigned long line, col;
+	unsigned long line, col = 1;
 
 	char * end = NULL;
-	line = strtol(params, &end, 10) - 1;
-	col  = strtol(++end, NULL, 10) - 1;
-
-	__ans_move_cursor(ctx, line, col);
+	line = strtol(params, &end, 10);
+	if (*end == ';')
+		col = strtol(end + 1, NULL, 10);
+
+	if (line == 0)
+		line = 1;
+	if (col == 0)
+		col = 1;
+	if (col > MAX_COL)
+		col = MAX_COL;
+
+	__ans_move_cursor(ctx, line - 1, col - 1);
 }
 
 static void __ans_move_cursor_up(struct ans_escape_seq_ctx * ctx,
@@ -107,8 +146,6 @@ unsigned long clamp_max(unsigned long val, unsigned long max)
 	return (val > max ? max : val);
 }
 
-#define MAX_COL 80
-
 static void __ans_move_cursor_forward(struct ans_escape_seq_ctx * ctx, unsigned long spaces)
 {
 	ctx->current_col = clamp_max(ctx->current_col + spaces, MAX_COL);
@@ -117,7 +154,12 @@ static void __ans_move_cursor_forward(struct ans_escape_seq_ctx * ctx, unsigned
 static void ans_move_cursor_forward(struct ans_escape_seq_ctx * ctx,
 				    char * params, unsigned long len)
 {
-	__ans_move_cursor_forward(ctx, strtol(params, NULL, 10));
+	unsigned long spaces = 1;
+
+	if (len != 0)
+		spaces = strtol(params, NULL, 10);
+
+	__ans_move_cursor_forward(ctx, spaces);
 }
 
 static void __ans_move_cursor_back(struct ans_escape_seq_ctx * ctx, unsigned long spaces)
@@ -131,7 +173,12 @@ static void __ans_move_cursor_back(struct ans_escape_seq_ctx * ctx, unsigned lon
 static void ans_move_cursor_back(struct ans_escape_seq_ctx * ctx,
 				 char * params, unsigned long len)
 {
-	__ans_move_cursor_back(ctx, strtol(params, NULL, 10));
+	unsigned long spaces = 1;
+
+	if (len != 0)
+		spaces = strtol(params, NULL, 10);
+
+	__ans_move_cursor_back(ctx, spaces);
 }
 
 static void __ans_save_cursor_pos(struct ans_escape_seq_ctx * ctx)
@@ -147,21 +194,81 @@ static void __ans_restore_cursor_pos(struct ans_escape_seq_ctx * ctx)
 	ctx->current_col  = ctx->saved_col;
 }
 
-static void ans_clear_screen(struct edit_buffer * buf,
+static unsigned long ans_attr(struct ans_escape_seq_ctx * ctx)
+{
+	unsigned char fg_color =
+		(ctx->bold == 1 ? ctx->fg_color + 8 : ctx->fg_color);
+
+	return COLOR_ATTR(fg_color, ctx->bg_color);
+}
+
+/* Blank columns from to to of a file row in the current colors.  */
+static void ans_erase(struct ans_reader * r, unsigned long row,
+		      unsigned long from, unsigned long to)
+{
+	struct edit_buffer * buf = r->buf;
+	unsigned long line = row - r->first_row;
+	int blank = CHAR_ATTR_TO_INT(ans_attr(&r->ctx), ' ');
+
+	if (row < r->low_row)
+		r->low_row = row;
+
+	if (!buf || row < r->first_row || line >= buf->height)
+		return;
+	for (; from < to && from < buf->width; from++)
+		edit_buffer_put(buf, from, line, blank);
+}
+
+/* 0 or nothing clears from the cursor down, 1 up to the cursor and 2
+   all of it, homing the cursor as ANSI.SYS does.  */
+static void ans_clear_screen(struct ans_reader * r,
 			     struct ans_escape_seq_ctx * ctx,
 			     char * params, int len)
 {
-	assert(len == 1);
-	assert(params[0] == '2');
-
-	edit_buffer_clear(buf);
-	ctx->current_col = 0;
-	ctx->current_line = 0;
+	unsigned long row;
+
+	switch (len ? params[0] : '0') {
+		case '0':
+			ans_erase(r, ctx->current_line, ctx->current_col,
+				  MAX_COL);
+			for (row = ctx->current_line + 1; row < r->nr_rows;
+			     row++)
+				ans_erase(r, row, 0, MAX_COL);
+			break;
+		case '1':
+			for (row = 0; row < ctx->current_line; row++)
+				ans_erase(r, row, 0, MAX_COL);
+			ans_erase(r, ctx->current_line, 0,
+				  ctx->current_col + 1);
+			break;
+		default:
+			if (r->buf)
+				edit_buffer_clear(r->buf);
+			r->low_row = 0;
+			ctx->current_col = 0;
+			ctx->current_line = 0;
+			break;
+	}
 }
 
-static void __ans_clear_eol(struct ans_escape_seq_ctx * ctx)
+/* Like ans_clear_screen() within the cursor row.  */
+static void ans_clear_line(struct ans_reader * r,
+			   struct ans_escape_seq_ctx * ctx,
+			   char * params, int len)
 {
-	assert(!"oops");
+	switch (len ? params[0] : '0') {
+		case '0':
+			ans_erase(r, ctx->current_line, ctx->current_col,
+				  MAX_COL);
+			break;
+		case '1':
+			ans_erase(r, ctx->current_line, 0,
+				  ctx->current_col + 1);
+			break;
+		default:
+			ans_erase(r, ctx->current_line, 0, MAX_COL);
+			break;
+	}
 }
 
 static void __ans_set_display_attr(struct ans_escape_seq_ctx * ctx,
@@ -182,8 +289,7 @@ static void __ans_set_display_attr(struct ans_escape_seq_ctx * ctx,
 		ctx->fg_color = attr - 30;
 	else if (attr >= 40 && attr <= 47)
 		ctx->bg_color = attr - 40;
-	else
-		error("unknown attr %i", attr);
+	/* Anything else is left alone.  */
 }
 
 static void ans_set_display_attrs(struct ans_escape_seq_ctx * ctx,
@@ -195,6 +301,8 @@ static void ans_set_display_attrs(struct ans_escape_seq_ctx * ctx,
 		if (end == params && attr == 0)
 			break;
 		__ans_set_display_attr(ctx, attr);
+		if (*end != ';')
+			break;
 		params = end + 1;
 	}
 }
@@ -210,9 +318,10 @@ static bool ans_eof(int ch)
 	return ch == EOF || ch == DOS_EOF;
 }
 
-static void ans_parse_seq(struct edit_buffer * buf,
-			  struct ans_escape_seq_ctx * ctx, FILE * input)
+static void ans_parse_seq(struct ans_reader * r)
 {
+	struct ans_escape_seq_ctx * ctx = &r->ctx;
+	FILE * input = r->input;
 #define MAX_PARAMS_LEN 32 
 	char params[MAX_PARAMS_LEN];
 	int len = 0;
@@ -220,19 +329,26 @@ static void ans_parse_seq(struct edit_buffer * buf,
 
 	memset(params, 0, MAX_PARAMS_LEN);
 
-	/* Parse parameters.  */
+	/* Parse parameters.  A sequence with more of them than fit is
+	   skipped.  */
 	for (;;) {
-		ch = fgetc(input);
+		ch = getc_unlocked(input);
 		if (!ans_param_char(ch))
 			break;
 
-		assert(len < MAX_PARAMS_LEN);
-		params[len++] = ch;
+		if (len < MAX_PARAMS_LEN - 1)
+			params[len] = ch;
+		len++;
 	}
-	if (ans_eof(ch))
-		error("corrupt escape sequence");
+	/* Leave the end of the file to the next read.  */
+	if (ans_eof(ch)) {
+		ungetc(ch, input);
+		return;
+	}
+	if (len >= MAX_PARAMS_LEN - 1)
+		return;
 
-	/* Parse command.  */
+	/* Parse command.  Unknown ones are ignored.  */
 	switch (ch) {
 		case 'H':
 		case 'f':
@@ -260,10 +376,10 @@ static void ans_parse_seq(struct edit_buffer * buf,
 			__ans_restore_cursor_pos(ctx);
 			break;
 		case 'J':
-			ans_clear_screen(buf, ctx, params, len);
+			ans_clear_screen(r, ctx, params, len);
 			break;
 		case 'K':
-			__ans_clear_eol(ctx);
+			ans_clear_line(r, ctx, params, len);
 			break;
 		case 'm':
 			ans_set_display_attrs(ctx, params, len);
@@ -275,7 +391,6 @@ static void ans_parse_seq(struct edit_buffer * buf,
 			/* reset screen mode */
 			break;
 		default:
-			error("escape code %c not supported", ch);
 			break;
 	}
 }
@@ -286,83 +401,522 @@ static void ans_crlf(struct ans_escape_seq_ctx * ctx)
 	ctx->current_line++;
 }
 
-static void ans_write_char(struct edit_buffer * buf,
-			   struct ans_escape_seq_ctx * ctx, int ch)
+static void ans_write_char(struct ans_reader * r, int ch)
 {
-	assert(ch != 7);
-	assert(ch != 8);
-	assert(ch != 9);
-	assert(ch != 11);
+	struct ans_escape_seq_ctx * ctx = &r->ctx;
 
 	if (ch == 10) {
 		ans_crlf(ctx);
 		return;
 	}
 
-	/* Ignore */
-	if (ch == 12 || ch == 13)
+	/* Tabs stop every 8 columns.  */
+	if (ch == 9) {
+		ctx->current_col = clamp_max((ctx->current_col / 8 + 1) * 8,
+					     MAX_COL);
+		return;
+	}
+
+	if (ch == 8) {
+		if (ctx->current_col > 0)
+			ctx->current_col--;
 		return;
+	}
 
-	assert(ch != 14);
-	assert(ch != 15);
-	assert(ch != 26);
-	assert(ch != 27);
-	assert(ch != 127);
+	/* Ignore the other controls.  */
+	if (ch == 7 || ch == 11 || ch == 12 || ch == 13 || ch == 14
+	    || ch == 15 || ch == 127)
+		return;
 
 	assert(ctx->current_col <= MAX_COL);
-	
+
 	if (ctx->current_col == MAX_COL)
 		ans_crlf(ctx);
 
-	unsigned char fg_color =
-		(ctx->bold == 1 ? ctx->fg_color + 8 : ctx->fg_color);
+	unsigned long attr = ans_attr(ctx);
 
-	unsigned long attr = COLOR_ATTR(fg_color, ctx->bg_color);
+	unsigned long line = ctx->current_line - r->first_row;
 
-	edit_buffer_put(buf,
-			ctx->current_col,
-			ctx->current_line, 
-                        CHAR_ATTR_TO_INT(attr, ch));
+	if (r->buf && ctx->current_line >= r->first_row
+	    && line < r->buf->height && ctx->current_col < r->buf->width)
+		edit_buffer_put(r->buf, ctx->current_col, line,
+				CHAR_ATTR_TO_INT(attr, ch));
 
+	if (ctx->current_line + 1 > r->nr_rows)
+		r->nr_rows = ctx->current_line + 1;
+	if (ctx->current_line < r->low_row)
+		r->low_row = ctx->current_line;
 
 	if (ctx->current_col < MAX_COL)
 		ctx->current_col++;
 }
 
+static bool ans_read_char(struct ans_reader * r)
+{
+	int ch = getc_unlocked(r->input);
+	if (ans_eof(ch))
+		return false;
+
+#define ESC_PREFIX 27
+	if (ch == ESC_PREFIX) {
+		int next = getc_unlocked(r->input);
+
+		/* A lone ESC is dropped.  */
+		if (next != '[') {
+			ungetc(next, r->input);
+			return true;
+		}
+		ans_parse_seq(r);
+	} else {
+		ans_write_char(r, ch);
+	}
+	return true;
+}
+
 void ans_read(FILE * input, struct edit_buffer * buffer)
 {
-	struct ans_escape_seq_ctx ctx = {
-		.current_line = 0,
-		.current_col  = 0,
-		.saved_line   = 0,
-		.saved_col    = 0,
-		.bold         = DEFAULT_BOLD,
-		.fg_color     = DEFAULT_FG_COLOR,
-		.bg_color     = DEFAULT_BG_COLOR
+	struct ans_reader r = {
+		.input     = input,
+		.buf       = buffer,
+		.first_row = 0,
+		.ctx       = initial_ctx
+	};
+
+	while (ans_read_char(&r))
+		;
+}
+
+/*
+ *	Streams
+ *
+ *	A stream reads a file a little at a time, for playing animations
+ *	back the way they came in over a modem.
+ */
+
+struct ans_stream {
+	struct ans_reader r;
+};
+
+struct ans_stream * ans_stream_open(FILE * input, struct edit_buffer * buf)
+{
+	struct ans_stream * s = calloc(1, sizeof(*s));
+
+	if (!s)
+		error("Could not allocate memory for stream.");
+
+	s->r.input = input;
+	s->r.buf = buf;
+	s->r.ctx = initial_ctx;
+	return s;
+}
+
+void ans_stream_close(struct ans_stream * s)
+{
+	free(s);
+}
+
+/* Read on up to byte end of the file.  Returns false at its end.  */
+bool ans_stream_read(struct ans_stream * s, long end)
+{
+	while (ftell(s->r.input) < end) {
+		if (!ans_read_char(&s->r))
+			return false;
+	}
+	return true;
+}
+
+void ans_stream_cursor(struct ans_stream * s, unsigned long * x,
+		       unsigned long * y)
+{
+	*x = s->r.ctx.current_col;
+	*y = s->r.ctx.current_line;
+}
+
+/*
+ *	Checkpoints
+ *
+ *	Reading a file once records the parser state every
+ *	ANS_CHECKPOINT_ROWS rows, the first time the cursor gets there.
+ *	Any row can then be reached by reading from the last checkpoint
+ *	before it.  Each checkpoint also keeps the lowest row drawn on
+ *	before the next one, so that bytes further on that move the cursor
+ *	back up can be found and read too.
+ */
+
+struct ans_checkpoint {
+	long offset;
+	struct ans_escape_seq_ctx ctx;
+	unsigned long nr_rows;		/* written to before it */
+	unsigned long low_row;		/* lowest row written to before the
+					   next one, 0 if not known */
+};
+
+static void ans_index_add(struct ans_index * index, long offset,
+			  struct ans_escape_seq_ctx * ctx)
+{
+	if (index->nr_checkpoints == index->max_checkpoints) {
+		index->max_checkpoints = index->max_checkpoints
+					 ? index->max_checkpoints * 2 : 64;
+		index->checkpoints = realloc(index->checkpoints,
+					     index->max_checkpoints
+					     * sizeof(struct ans_checkpoint));
+		if (!index->checkpoints)
+			error("Could not allocate memory for index.");
+	}
+
+	struct ans_checkpoint * cp = &index->checkpoints[index->nr_checkpoints++];
+	cp->offset = offset;
+	cp->ctx = *ctx;
+	cp->nr_rows = 0;
+	cp->low_row = 0;
+}
+
+/* Carry on reading from the checkpoint.  */
+static void ans_resume(struct ans_reader * r, struct ans_checkpoint * cp)
+{
+	r->ctx = cp->ctx;
+	r->nr_rows = cp->nr_rows;
+	fseek(r->input, cp->offset, SEEK_SET);
+}
+
+/* Read on from where the reader is, adding checkpoints as it goes.  */
+static void ans_read_indexed(struct ans_reader * r, struct ans_index * index)
+{
+	struct ans_checkpoint * cp = NULL;
+	unsigned long next_row = 0;
+
+	do {
+		if (r->ctx.current_line >= next_row) {
+			if (cp)
+				cp->low_row = r->low_row;
+			ans_index_add(index, ftell(r->input), &r->ctx);
+			cp = &index->checkpoints[index->nr_checkpoints - 1];
+			cp->nr_rows = r->nr_rows;
+			r->low_row = ULONG_MAX;
+			next_row = (r->ctx.current_line / ANS_CHECKPOINT_ROWS + 1)
+				   * ANS_CHECKPOINT_ROWS;
+		}
+	} while (ans_read_char(r));
+
+	if (cp)
+		cp->low_row = r->low_row;
+	index->nr_rows = r->nr_rows;
+}
+
+void ans_index_build(FILE * input, struct ans_index * index)
+{
+	struct ans_reader r = {
+		.input = input,
+		.buf   = NULL,
+		.ctx   = initial_ctx
+	};
+
+	memset(index, 0, sizeof(*index));
+	rewind(input);
+	ans_read_indexed(&r, index);
+}
+
+/*
+ *	Rereading
+ *
+ *	Everything a file draws from checkpoint k on comes from the bytes
+ *	after it, as long as none of them go back above its row: before it
+ *	the cursor never got that far.  So when the bytes from some offset
+ *	on change, only the rows from the last checkpoint in front of it
+ *	need reading again.  If the old or new bytes after it reach back
+ *	above that row, the whole file is read again instead.
+ */
+
+/* Returns the checkpoint to read again from, or nr_checkpoints if the
+   whole file has to be read.  */
+static unsigned long ans_reread_from(struct ans_index * index, long changed)
+{
+	unsigned long k = index->nr_checkpoints, i;
+	unsigned long low = ULONG_MAX;
+
+	while (k > 0 && index->checkpoints[k - 1].offset > changed)
+		k--;
+	if (k == 0)
+		return index->nr_checkpoints;
+
+	/* Lowest row the old bytes from checkpoint k - 1 on wrote to.  */
+	for (i = index->nr_checkpoints; i >= k; i--) {
+		if (index->checkpoints[i - 1].low_row < low)
+			low = index->checkpoints[i - 1].low_row;
+	}
+	if (low < index->checkpoints[k - 1].ctx.current_line)
+		return index->nr_checkpoints;
+	return k - 1;
+}
+
+static void ans_clear_rows(struct edit_buffer * buf, unsigned long first)
+{
+	unsigned long i;
+
+	for (i = first * buf->width; i < buf->height * buf->width; i++)
+		buf->buffer[i] = 0x0720;
+	if (buf->max_height > first)
+		buf->max_height = first;
+}
+
+/*
+ *	Read the file into buf again after the bytes from offset changed on
+ *	have changed, and bring the index up to date.  Only the rows from
+ *	the one returned on are read; the ones above it are as before.
+ */
+unsigned long ans_reread(FILE * input, struct edit_buffer * buf,
+			 struct ans_index * index, long changed)
+{
+	unsigned long k = ans_reread_from(index, changed);
+	struct ans_reader r = {
+		.input = input,
+		.buf   = buf,
+		.ctx   = initial_ctx
+	};
+	struct ans_checkpoint cp;
+
+	if (k == index->nr_checkpoints) {
+		ans_index_release(index);
+		rewind(input);
+		ans_clear_rows(buf, 0);
+		ans_read_indexed(&r, index);
+		return 0;
+	}
+
+	cp = index->checkpoints[k];
+	index->nr_checkpoints = k;
+	ans_resume(&r, &cp);
+
+	ans_clear_rows(buf, cp.ctx.current_line);
+	if (buf->max_height < cp.nr_rows)
+		buf->max_height = cp.nr_rows < buf->height ? cp.nr_rows
+							   : buf->height;
+	ans_read_indexed(&r, index);
+
+	/* Went back above the row after all.  */
+	if (ans_reread_from(index, cp.offset) != k)
+		return ans_reread(input, buf, index, 0);
+
+	return cp.ctx.current_line;
+}
+
+void ans_index_release(struct ans_index * index)
+{
+	free(index->checkpoints);
+	memset(index, 0, sizeof(*index));
+}
+
+/*
+ *	Fill the buffer with file rows first_row onwards.  Reading stops
+ *	once the cursor is past the last of them, after which only the
+ *	stretches between checkpoints that go back up to draw above it
+ *	are read.
+ */
+void ans_read_rows(FILE * input, struct edit_buffer * buffer,
+		   struct ans_index * index, unsigned long first_row)
+{
+	struct ans_reader r = {
+		.input     = input,
+		.buf       = buffer,
+		.first_row = first_row,
+		.ctx       = initial_ctx
 	};
+	unsigned long last_row = first_row + buffer->height;
+	unsigned long lo = 0, hi = index->nr_checkpoints, k;
+
+	/* Last checkpoint at or before the first row.  */
+	while (lo < hi) {
+		unsigned long mid = (lo + hi) / 2;
+
+		if (index->checkpoints[mid].ctx.current_line <= first_row)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	edit_buffer_clear(buffer);
+	if (lo > 0)
+		ans_resume(&r, &index->checkpoints[lo - 1]);
+	else
+		fseek(input, 0, SEEK_SET);
+
+	while (r.ctx.current_line < last_row && ans_read_char(&r))
+		;
+
+	for (k = lo > 0 ? lo - 1 : 0; k < index->nr_checkpoints; k++) {
+		struct ans_checkpoint * cp = &index->checkpoints[k];
+		long end = k + 1 < index->nr_checkpoints
+			   ? index->checkpoints[k + 1].offset : LONG_MAX;
+		long pos = ftell(input);
+
+		if (cp->low_row >= last_row || pos >= end)
+			continue;
+		if (pos < cp->offset)
+			ans_resume(&r, cp);
+		while (ftell(input) < end && ans_read_char(&r))
+			;
+	}
+}
+
+/*
+ *	Index files
+ *
+ *	The index is kept next to the file it was built from as "NDAI", a
+ *	version byte, the size and modification time of the file, the
+ *	number of rows and the checkpoints, all as varints.  It is rebuilt
+ *	when the file no longer matches.
+ */
+
+#define INDEX_MAGIC "NDAI"
+#define INDEX_MAGIC_LEN 4
+#define INDEX_VERSION 2
+
+static void put_varint(FILE * file, unsigned long long value)
+{
+	while (value >= 0x80) {
+		fputc((value & 0x7F) | 0x80, file);
+		value >>= 7;
+	}
+	fputc(value, file);
+}
+
+static bool get_varint(FILE * file, unsigned long long * value)
+{
+	unsigned int shift = 0;
 
+	*value = 0;
 	for (;;) {
-		int ch = fgetc(input);
-		if (ans_eof(ch))
-			break;
+		int ch = fgetc(file);
+		if (ch == EOF || shift > 63)
+			return false;
+
+		*value |= (unsigned long long) (ch & 0x7F) << shift;
+		if (!(ch & 0x80))
+			return true;
+		shift += 7;
+	}
+}
 
-#define ESC_PREFIX 27
-		if (ch == ESC_PREFIX) {
-			int next = fgetc(input);
-			if (next != '[')
-				error("corrupt escape sequence");
-			ans_parse_seq(buffer, &ctx, input);
-		} else {
-			ans_write_char(buffer, &ctx, ch);
+static void put_source(FILE * file, struct stat * st)
+{
+	put_varint(file, st->st_size);
+	put_varint(file, st->st_mtim.tv_sec);
+	put_varint(file, st->st_mtim.tv_nsec);
+}
+
+static bool ans_index_load(const char * path, struct stat * source,
+			   struct ans_index * index)
+{
+	unsigned long long size, sec, nsec, nr_rows, nr, i;
+	unsigned long long v[10];
+	char magic[INDEX_MAGIC_LEN];
+	FILE * file = fopen(path, "rb");
+	bool ok = false;
+
+	if (!file)
+		return false;
+
+	memset(index, 0, sizeof(*index));
+	if (fread(magic, 1, INDEX_MAGIC_LEN, file) != INDEX_MAGIC_LEN
+	    || memcmp(magic, INDEX_MAGIC, INDEX_MAGIC_LEN) != 0
+	    || fgetc(file) != INDEX_VERSION
+	    || !get_varint(file, &size) || !get_varint(file, &sec)
+	    || !get_varint(file, &nsec) || !get_varint(file, &nr_rows)
+	    || !get_varint(file, &nr))
+		goto out;
+
+	if (size != source->st_size || sec != source->st_mtim.tv_sec
+	    || nsec != source->st_mtim.tv_nsec)
+		goto out;
+
+	for (i = 0; i < nr; i++) {
+		int j;
+
+		for (j = 0; j < 10; j++) {
+			if (!get_varint(file, &v[j]))
+				goto out;
 		}
+
+		struct ans_escape_seq_ctx ctx = {
+			.current_line = v[1],
+			.current_col  = v[2],
+			.saved_line   = v[3],
+			.saved_col    = v[4],
+			.bold         = v[5],
+			.fg_color     = v[6],
+			.bg_color     = v[7]
+		};
+		ans_index_add(index, v[0], &ctx);
+		index->checkpoints[i].nr_rows = v[8];
+		index->checkpoints[i].low_row = v[9];
+	}
+	index->nr_rows = nr_rows;
+	ok = true;
+out:
+	fclose(file);
+	if (!ok)
+		ans_index_release(index);
+	return ok;
+}
+
+static void ans_index_store(const char * path, struct stat * source,
+			    struct ans_index * index)
+{
+	FILE * file = fopen(path, "wb");
+	unsigned long i;
+
+	if (!file)
+		return;
+
+	fwrite(INDEX_MAGIC, 1, INDEX_MAGIC_LEN, file);
+	fputc(INDEX_VERSION, file);
+	put_source(file, source);
+	put_varint(file, index->nr_rows);
+	put_varint(file, index->nr_checkpoints);
+
+	for (i = 0; i < index->nr_checkpoints; i++) {
+		struct ans_checkpoint * cp = &index->checkpoints[i];
+
+		put_varint(file, cp->offset);
+		put_varint(file, cp->ctx.current_line);
+		put_varint(file, cp->ctx.current_col);
+		put_varint(file, cp->ctx.saved_line);
+		put_varint(file, cp->ctx.saved_col);
+		put_varint(file, cp->ctx.bold);
+		put_varint(file, cp->ctx.fg_color);
+		put_varint(file, cp->ctx.bg_color);
+		put_varint(file, cp->nr_rows);
+		put_varint(file, cp->low_row);
+	}
+
+	/* A partial index is rejected when loading, so drop it now.  */
+	if (fclose(file) != 0)
+		unlink(path);
+}
+
+/* Use the index kept for the file at path, or build and keep one.  */
+void ans_index_open(FILE * input, const char * path, struct ans_index * index)
+{
+	char * index_path = malloc(strlen(path) + sizeof(".index"));
+	struct stat st;
+
+	if (!index_path)
+		error("Could not allocate memory for file name.");
+	sprintf(index_path, "%s.index", path);
+
+	if (fstat(fileno(input), &st) != 0
+	    || !ans_index_load(index_path, &st, index)) {
+		ans_index_build(input, index);
+		ans_index_store(index_path, &st, index);
 	}
+	free(index_path);
 }
 
 /*
  *	Writing
  */
 
-static void ans_write_attr(FILE * output, int attr)
+static int ans_write_attr(FILE * output, int attr)
 {
 	bool bold = false;
 	unsigned char fg_color = attr & 0x0F; 
@@ -374,28 +928,46 @@ static void ans_write_attr(FILE * output, int attr)
 
 	unsigned char bg_color = (attr & 0xF0) >> 4;
 		
-	fprintf(output, "\x1B[%i;%i;%im",
+	return fprintf(output, "\x1B[%i;%i;%im",
 		(bold ? 1 : 0),
 		fg_color + 30,
 		bg_color + 40);
 }
 
-void ans_write(FILE * output, struct edit_buffer * buf)
+/*
+ *	Write rows first..last - 1 so that a long write can be split up.
+ *	Every row sets the attribute of its first cell, so the bytes of a
+ *	row depend on nothing but its cells and read back the same after
+ *	any other row.  Returns the number of bytes written.
+ */
+unsigned long ans_write_rows(FILE * output, struct edit_buffer * buf,
+			     unsigned long first, unsigned long last)
 {
-	unsigned long x, y;
-	for (y = 0; y < buf->max_height; y++) {
-		int prev_attr = 0;
+	unsigned long x, y, len = 0;
+
+	if (last > buf->max_height)
+		last = buf->max_height;
+
+	for (y = first; y < last; y++) {
+		int prev_attr = -1;
 
 		for (x = 0; x < buf->width; x++) {
 			int attr = (edit_buffer_get(buf, x, y) & 0xFF00) >> 8;
 
 			if (attr != prev_attr)
-				ans_write_attr(output, attr);
+				len += ans_write_attr(output, attr);
 			prev_attr = attr;
 
 			int ch = edit_buffer_get(buf, x, y) & 0xFF;
 			fputc(ch, output);
 		}
 		fputc('\n', output);
+		len += buf->width + 1;
 	}
+	return len;
+}
+
+void ans_write(FILE * output, struct edit_buffer * buf)
+{
+	ans_write_rows(output, buf, 0, buf->max_height);
 }
@@ -1,10 +1,38 @@
 #ifndef _ANSI_ESC_H_
 #define _ANSI_ESC_H_ 1
 
+#include <stdbool.h>
 #include <stdio.h>
 struct edit_buffer;
+struct ans_checkpoint;
+struct ans_stream;
+
+/* Parser state is recorded this many rows apart.  */
+#define ANS_CHECKPOINT_ROWS 128
+
+struct ans_index {
+	unsigned long nr_rows;		/* rows the file draws on */
+	unsigned long nr_checkpoints;
+	unsigned long max_checkpoints;
+	struct ans_checkpoint * checkpoints;
+};
 
 void ans_read(FILE * input, struct edit_buffer * buffer);
+void ans_read_rows(FILE * input, struct edit_buffer * buffer,
+		   struct ans_index * index, unsigned long first_row);
+void ans_index_build(FILE * input, struct ans_index * index);
+void ans_index_open(FILE * input, const char * path,
+		    struct ans_index * index);
+void ans_index_release(struct ans_index * index);
+unsigned long ans_reread(FILE * input, struct edit_buffer * buffer,
+			 struct ans_index * index, long changed);
+struct ans_stream * ans_stream_open(FILE * input, struct edit_buffer * buffer);
+void ans_stream_close(struct ans_stream * stream);
+bool ans_stream_read(struct ans_stream * stream, long end);
+void ans_stream_cursor(struct ans_stream * stream, unsigned long * x,
+		       unsigned long * y);
 void ans_write(FILE * output, struct edit_buffer * buffer);
+unsigned long ans_write_rows(FILE * output, struct edit_buffer * buffer,
+			     unsigned long first, unsigned long last);
 
 #endif
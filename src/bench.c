@@ -0,0 +1,900 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "animation.h"
+#include "ansi-esc.h"
+#include "bytes.h"
+#include "cell-diff.h"
+#include "colors.h"
+#include "edit-buffer.h"
+#include "editor-context.h"
+#include "error.h"
+#include "font.h"
+#include "html-export.h"
+#include "input.h"
+#include "png-export.h"
+#include "screen.h"
+#include "search.h"
+#include "utf8-export.h"
+
+/*
+ *	Rendering benchmark
+ *
+ *	Replays scripted cursor and scroll sessions against a large
+ *	generated canvas on a headless screen backend and reports frame
+ *	times.
+ */
+
+static char highascii_set[11] = {
+	176, 177, 178, 219, 220, 223, 221, 222, 22, 254, 32
+};
+
+static struct editor_context ctx = {
+	.fg_color = 0x07,
+	.bg_color = 0x00,
+	.save_progress = -1
+};
+
+static unsigned long * frame_times;
+static unsigned long nr_frames;
+static unsigned long max_frames;
+
+static unsigned long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+static bool bench_frame(struct edit_buffer * buf, struct screen * scr)
+{
+	unsigned long start = now_ns();
+
+	screen_draw_edit_buffer(scr, buf);
+	screen_print_status(buf, scr, &ctx, highascii_set);
+	screen_move(scr->cursor_y, scr->cursor_x);
+	screen_refresh();
+
+	frame_times[nr_frames++] = now_ns() - start;
+
+	return nr_frames < max_frames;
+}
+
+/*
+ *	Canvas with runs of block characters in random colors, roughly
+ *	what real art looks like to the renderer.
+ */
+static unsigned long rand_state = 1;
+
+static unsigned long bench_rand(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+	return (rand_state >> 16) & 0x7FFF;
+}
+
+static void fill_canvas(struct edit_buffer * buf)
+{
+	static const unsigned char glyphs[] = {
+		' ', ' ', 176, 177, 178, 219, 220, 223, 221, 222, 254, '.'
+	};
+	unsigned long x, y;
+	unsigned long run = 0;
+	int ch = ' ', attr = COLOR_ATTR(7, 0);
+
+	for (y = 0; y < buf->height; y++) {
+		for (x = 0; x < buf->width; x++) {
+			if (run == 0) {
+				run = 1 + bench_rand() % 16;
+				ch = glyphs[bench_rand() % sizeof(glyphs)];
+				attr = COLOR_ATTR(bench_rand() % 16,
+						  bench_rand() % 8);
+			}
+			run--;
+			edit_buffer_put(buf, x, y, CHAR_ATTR_TO_INT(attr, ch));
+		}
+	}
+}
+
+/*
+ *	Sessions
+ */
+
+/* Walk the cursor over the viewport typing characters.  */
+static void session_cursor(struct edit_buffer * buf, struct screen * scr)
+{
+	for (;;) {
+		edit_buffer_put(buf, buf->start_x + scr->cursor_x,
+				buf->start_y + scr->cursor_y,
+				CHAR_ATTR_TO_INT(COLOR_ATTR(bench_rand() % 16, 0),
+						 highascii_set[bench_rand() % 10]));
+
+		if (++scr->cursor_x == scr->width) {
+			scr->cursor_x = 0;
+			if (++scr->cursor_y == scr->height)
+				scr->cursor_y = 0;
+		}
+		if (!bench_frame(buf, scr))
+			break;
+	}
+}
+
+/* Scroll down the canvas a line at a time and back up.  */
+static void session_scroll(struct edit_buffer * buf, struct screen * scr)
+{
+	unsigned long max_start = buf->height - scr->height;
+
+	for (;;) {
+		while (buf->start_y < max_start) {
+			buf->start_y++;
+			if (!bench_frame(buf, scr))
+				return;
+		}
+		while (buf->start_y > 0) {
+			buf->start_y--;
+			if (!bench_frame(buf, scr))
+				return;
+		}
+	}
+}
+
+/* Page down the canvas and back up.  */
+static void session_page(struct edit_buffer * buf, struct screen * scr)
+{
+	unsigned long max_start = buf->height - scr->height;
+
+	for (;;) {
+		while (buf->start_y < max_start) {
+			buf->start_y += scr->height;
+			if (buf->start_y > max_start)
+				buf->start_y = max_start;
+			if (!bench_frame(buf, scr))
+				return;
+		}
+		while (buf->start_y > 0) {
+			buf->start_y -= (buf->start_y > scr->height ?
+					 scr->height : buf->start_y);
+			if (!bench_frame(buf, scr))
+				return;
+		}
+	}
+}
+
+struct session {
+	const char * name;
+	void (*run)(struct edit_buffer *, struct screen *);
+};
+
+static struct session sessions[] = {
+	{ "cursor", session_cursor },
+	{ "scroll", session_scroll },
+	{ "page",   session_page },
+	{ NULL,     NULL }
+};
+
+/*
+ *	Reporting
+ */
+
+static int compare_ulong(const void * a, const void * b)
+{
+	unsigned long x = *(const unsigned long *) a;
+	unsigned long y = *(const unsigned long *) b;
+
+	return (x > y) - (x < y);
+}
+
+static void report(const char * backend, const char * session,
+		   struct screen_stats * stats)
+{
+	unsigned long total = 0;
+	unsigned long i;
+
+	for (i = 0; i < nr_frames; i++)
+		total += frame_times[i];
+
+	qsort(frame_times, nr_frames, sizeof(unsigned long), compare_ulong);
+
+	printf("%-8s %-8s %7lu %10.1f %9.1f %9.1f %10lu %10lu\n",
+	       backend, session, nr_frames,
+	       nr_frames / (total / 1e9),
+	       frame_times[nr_frames * 50 / 100] / 1e3,
+	       frame_times[nr_frames * 99 / 100] / 1e3,
+	       stats->cells_drawn / nr_frames,
+	       stats->bytes_out / nr_frames);
+}
+
+/*
+ *	Input latency
+ *
+ *	A producer thread feeds scroll keys through the input ring faster
+ *	than frames can be drawn.  Latency is measured from queueing a key
+ *	to refreshing the first frame that shows it, either applying
+ *	everything queued before each frame or drawing a frame per key.
+ */
+static unsigned long key_interval_us = 20;
+static unsigned long nr_keys;
+static unsigned long * latencies;
+
+/* Sleeps are coarser than the interval, so every wakeup pushes all
+   the keys that are due by then.  */
+static void * key_producer(void * arg)
+{
+	unsigned long next = input_now();
+	unsigned long i = 0;
+
+	while (i < nr_keys) {
+		struct timespec deadline = {
+			.tv_sec  = next / 1000000000UL,
+			.tv_nsec = next % 1000000000UL
+		};
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+
+		unsigned long now = input_now();
+		while (i < nr_keys && next <= now) {
+			input_push(KEY_DOWN);
+			next += key_interval_us * 1000;
+			i++;
+		}
+	}
+	return NULL;
+}
+
+static void bench_latency(const char * backend, struct edit_buffer * buf,
+			  struct screen * scr, bool batched)
+{
+	unsigned long max_start = buf->height - scr->height;
+	unsigned long timestamps[INPUT_RING_SIZE];
+	unsigned long nr_done = 0;
+	unsigned long frames = 0;
+	pthread_t producer;
+
+	input_init();
+	if (pthread_create(&producer, NULL, key_producer, NULL) != 0)
+		error("Could not create producer thread.");
+
+	while (nr_done < nr_keys) {
+		struct input_event event;
+		unsigned long i, nr = 0;
+
+		input_wait();
+		while (nr < INPUT_RING_SIZE && input_next_event(&event)) {
+			buf->start_y = (buf->start_y + 1) % max_start;
+			timestamps[nr++] = event.timestamp;
+			if (!batched)
+				break;
+		}
+
+		screen_draw_edit_buffer(scr, buf);
+		screen_print_status(buf, scr, &ctx, highascii_set);
+		screen_move(scr->cursor_y, scr->cursor_x);
+		screen_refresh();
+		frames++;
+
+		unsigned long now = input_now();
+		for (i = 0; i < nr; i++)
+			latencies[nr_done++] = now - timestamps[i];
+	}
+
+	pthread_join(producer, NULL);
+	input_stop();
+
+	qsort(latencies, nr_done, sizeof(unsigned long), compare_ulong);
+
+	printf("%-8s %-8s %7lu %10lu %9.1f %9.1f %10.1f\n",
+	       backend, batched ? "batched" : "per-key", nr_done, frames,
+	       latencies[nr_done * 50 / 100] / 1e3,
+	       latencies[nr_done * 99 / 100] / 1e3,
+	       latencies[nr_done - 1] / 1e3);
+}
+
+/*
+ *	Export
+ *
+ *	Writes a piece of the size of a large ANSI several times over with
+ *	each exporter and reports the time per export and the output size.
+ */
+
+#define EXPORT_ROWS 1000
+#define EXPORT_RUNS 20
+
+static bool export_png_8x16(FILE * output, struct edit_buffer * buf)
+{
+	return png_export(output, buf, &font_8x16);
+}
+
+static bool export_png_8x8(FILE * output, struct edit_buffer * buf)
+{
+	return png_export(output, buf, &font_8x8);
+}
+
+static bool export_html(FILE * output, struct edit_buffer * buf)
+{
+	return html_export(output, buf, "bench");
+}
+
+static bool export_utf8(FILE * output, struct edit_buffer * buf)
+{
+	return utf8_export(output, buf, false);
+}
+
+static bool export_utf8_24(FILE * output, struct edit_buffer * buf)
+{
+	return utf8_export(output, buf, true);
+}
+
+static const struct exporter {
+	const char * name;
+	bool (*export)(FILE *, struct edit_buffer *);
+} exporters[] = {
+	{ "png-8x16",	export_png_8x16 },
+	{ "png-8x8",	export_png_8x8 },
+	{ "html",	export_html },
+	{ "utf8",	export_utf8 },
+	{ "utf8-24",	export_utf8_24 },
+	{ NULL,		NULL }
+};
+
+static void bench_export(unsigned long cols)
+{
+	struct edit_buffer * buf = edit_buffer_create(cols, EXPORT_ROWS);
+	const struct exporter * exporter;
+	FILE * output = tmpfile();
+
+	if (!output)
+		error("Could not create temporary file.");
+
+	rand_state = 1;
+	fill_canvas(buf);
+
+	printf("%-8s %7s %7s %10s %10s %10s\n", "export", "rows", "runs",
+	       "ms", "bytes", "MB/s");
+
+	for (exporter = exporters; exporter->name; exporter++) {
+		unsigned long start, elapsed, bytes = 0;
+		int i;
+
+		for (i = 0; i < EXPORT_RUNS; i++) {
+			/* The first run only sizes the output.  */
+			if (i == 1)
+				start = now_ns();
+			exporter->export(output, buf);
+			if (i == 0)
+				bytes = ftell(output);
+			rewind(output);
+		}
+		elapsed = now_ns() - start;
+
+		printf("%-8s %7lu %7d %10.2f %10lu %10.1f\n", exporter->name,
+		       buf->max_height, EXPORT_RUNS - 1,
+		       elapsed / 1e6 / (EXPORT_RUNS - 1), bytes,
+		       bytes * (EXPORT_RUNS - 1) / (elapsed / 1e3));
+	}
+
+	fclose(output);
+	edit_buffer_release(buf);
+}
+
+/*
+ *	Diff benchmark
+ *
+ *	Diffs the canvas against edited copies of itself and reports the
+ *	time to find the changed rectangles and to write and apply a patch.
+ */
+
+#define DIFF_RUNS 20
+
+/* Scatter nr_edits small rectangles of changed cells over the canvas.  */
+static void edit_canvas(struct edit_buffer * buf, unsigned long nr_edits)
+{
+	unsigned long i, x, y;
+
+	for (i = 0; i < nr_edits; i++) {
+		unsigned long x0 = bench_rand() * buf->width / 0x8000;
+		unsigned long y0 = (bench_rand() << 15 | bench_rand())
+				   % buf->height;
+		unsigned int cell = CHAR_ATTR_TO_INT(COLOR_ATTR(15, 4), '#');
+
+		for (y = y0; y < y0 + 4 && y < buf->height; y++)
+			for (x = x0; x < x0 + 8 && x < buf->width; x++)
+				edit_buffer_put(buf, x, y, cell);
+	}
+}
+
+static void bench_diff(unsigned long cols, unsigned long rows)
+{
+	static const unsigned long edits[] = { 0, 10, 1000, 20000 };
+	struct edit_buffer * a = edit_buffer_create(cols, rows);
+	FILE * output = tmpfile();
+	unsigned long e;
+
+	if (!output)
+		error("Could not create temporary file.");
+
+	rand_state = 1;
+	fill_canvas(a);
+
+	printf("%-8s %7s %7s %9s %10s %10s %10s\n", "edits", "rows", "rects",
+	       "cells", "diff ms", "patch B", "apply ms");
+
+	for (e = 0; e < sizeof(edits) / sizeof(edits[0]); e++) {
+		struct edit_buffer * b = edit_buffer_clone(a);
+		struct cell_diff diff = { 0, 0, NULL, 0 };
+		unsigned long start, diff_ns, apply_ns = 0, len = 0;
+		unsigned char * patch;
+		int i;
+
+		edit_canvas(b, edits[e]);
+
+		start = now_ns();
+		for (i = 0; i < DIFF_RUNS; i++)
+			cell_diff(a, b, &diff);
+		diff_ns = (now_ns() - start) / DIFF_RUNS;
+
+		rewind(output);
+		if (!patch_write(output, a, b, &diff))
+			error("Could not write patch.");
+		len = ftell(output);
+		patch = malloc(len);
+		if (!patch)
+			error("Could not allocate memory for patch.");
+		rewind(output);
+		if (fread(patch, 1, len, output) != len)
+			error("Could not read patch.");
+
+		for (i = 0; i < DIFF_RUNS; i++) {
+			struct edit_buffer * c = edit_buffer_clone(a);
+
+			start = now_ns();
+			if (patch_apply(patch, len, c) != PATCH_APPLIED)
+				error("Patch did not apply.");
+			apply_ns += now_ns() - start;
+			edit_buffer_release(c);
+		}
+
+		printf("%-8lu %7lu %7lu %9lu %10.3f %10lu %10.3f\n", edits[e],
+		       rows, diff.nr_rects, diff.nr_cells, diff_ns / 1e6, len,
+		       apply_ns / 1e6 / DIFF_RUNS);
+
+		free(patch);
+		cell_diff_release(&diff);
+		edit_buffer_release(b);
+	}
+
+	fclose(output);
+	edit_buffer_release(a);
+}
+
+/*
+ *	Search benchmark
+ *
+ *	Finds every match of a few patterns in the canvas: a string that
+ *	never matches, so the whole canvas is scanned for its anchor, and
+ *	text and block patterns that turn up now and then.
+ */
+
+#define SEARCH_RUNS 20
+
+static void bench_search(unsigned long cols, unsigned long rows)
+{
+	static const char * queries[] = {
+		"newdraw", "\\xdb\\xdb", "\\xb0\\xb1\\n\\xb2\\xdb", NULL
+	};
+	struct edit_buffer * buf = edit_buffer_create(cols, rows);
+	const char ** query;
+
+	rand_state = 1;
+	fill_canvas(buf);
+
+	printf("%-20s %7s %9s %10s %10s\n", "search", "rows", "matches",
+	       "ms", "MB/s");
+
+	for (query = queries; *query; query++) {
+		struct search_pattern * p = search_compile(*query);
+		unsigned long start, elapsed, nr_matches = 0, from, x, y;
+		int i;
+
+		start = now_ns();
+		for (i = 0; i < SEARCH_RUNS; i++) {
+			nr_matches = 0;
+			from = 0;
+			while (search_find(buf, p, from, &x, &y)) {
+				nr_matches++;
+				from = y * buf->width + x + 1;
+			}
+		}
+		elapsed = (now_ns() - start) / SEARCH_RUNS;
+
+		printf("%-20s %7lu %9lu %10.3f %10.1f\n", *query, rows,
+		       nr_matches, elapsed / 1e6,
+		       cols * rows * sizeof(unsigned int) / (elapsed / 1e3));
+		search_release(p);
+	}
+
+	edit_buffer_release(buf);
+}
+
+/*
+ *	Reread benchmark
+ *
+ *	Writes the canvas out as ANSI, puts a glyph in at the start of a
+ *	row some way into the file and reads it in again, both whole and
+ *	from the checkpoint in front of the change as a watched file is.
+ */
+
+#define REREAD_RUNS 20
+
+static void bench_reread(unsigned long cols, unsigned long rows)
+{
+	static const unsigned int at[] = { 0, 50, 90, 100 };
+	struct edit_buffer * buf = edit_buffer_create(cols, rows);
+	FILE * output = tmpfile();
+	unsigned char * data;
+	unsigned long len, i;
+
+	if (!output)
+		error("Could not create temporary file.");
+
+	rand_state = 1;
+	fill_canvas(buf);
+	ans_write(output, buf);
+	len = ftell(output);
+	data = malloc(len + 1);
+	if (!data)
+		error("Could not allocate memory for file.");
+	rewind(output);
+	if (fread(data, 1, len, output) != len)
+		error("Could not read file.");
+	fclose(output);
+
+	printf("%-8s %7s %10s %10s %10s\n", "at %", "rows", "from row",
+	       "full ms", "reread ms");
+
+	for (i = 0; i < sizeof(at) / sizeof(at[0]); i++) {
+		unsigned char * changed = malloc(len + 1);
+		unsigned long offset = len * at[i] / 100, start, full_ns;
+		unsigned long reread_ns = 0, row = 0;
+		struct ans_index index;
+		FILE * input;
+		int run;
+
+		if (!changed)
+			error("Could not allocate memory for file.");
+
+		/* Right after a newline, where a glyph is just a glyph.  */
+		while (offset > 0 && data[offset - 1] != '\n')
+			offset--;
+		memcpy(changed, data, offset);
+		changed[offset] = '#';
+		memcpy(changed + offset + 1, data + offset, len - offset);
+
+		memset(&index, 0, sizeof(index));
+		input = fmemopen(data, len, "r");
+		ans_reread(input, buf, &index, 0);
+		fclose(input);
+
+		start = now_ns();
+		for (run = 0; run < REREAD_RUNS; run++) {
+			input = fmemopen(changed, len + 1, "r");
+			ans_read(input, buf);
+			fclose(input);
+		}
+		full_ns = (now_ns() - start) / REREAD_RUNS;
+
+		/* The index is of the changed file after the first run, but
+		   it is the same up to the change.  */
+		for (run = 0; run < REREAD_RUNS; run++) {
+			input = fmemopen(changed, len + 1, "r");
+			start = now_ns();
+			row = ans_reread(input, buf, &index, offset);
+			reread_ns += now_ns() - start;
+			fclose(input);
+		}
+
+		printf("%-8u %7lu %10lu %10.3f %10.3f\n", at[i], rows, row,
+		       full_ns / 1e6, reread_ns / 1e6 / REREAD_RUNS);
+
+		ans_index_release(&index);
+		free(changed);
+	}
+
+	free(data);
+	edit_buffer_release(buf);
+}
+
+/*
+ *	Animation benchmark
+ *
+ *	Plays a generated animation that draws runs of blocks all over a
+ *	screen and clears it now and then, a tick of a 28800 baud modem to
+ *	a frame.  Then it jumps to random frames and steps back one frame
+ *	at a time, and compares that with reading the file again up to the
+ *	frame.
+ */
+
+#define PLAY_BYTES_PER_FRAME 58		/* 20 ms at 28800 baud */
+#define PLAY_SEEKS 1000
+#define PLAY_REREADS 20
+
+static FILE * make_animation(unsigned long nr_runs)
+{
+	FILE * output = tmpfile();
+	unsigned long i, n;
+
+	if (!output)
+		error("Could not create temporary file.");
+
+	fprintf(output, "\x1b[2J");
+	for (i = 0; i < nr_runs; i++) {
+		fprintf(output, "\x1b[%lu;%luH\x1b[1;%lum",
+			bench_rand() % 25 + 1, bench_rand() % 60 + 1,
+			30 + bench_rand() % 8);
+		for (n = bench_rand() % 16 + 4; n > 0; n--)
+			fputc(0xb0 + bench_rand() % 3, output);
+		if (bench_rand() % 200 == 0)
+			fprintf(output, "\x1b[2J");
+	}
+	rewind(output);
+	return output;
+}
+
+static void bench_play(unsigned long cols, unsigned long rows)
+{
+	FILE * input, * copy;
+	struct anim * a;
+	unsigned long start, record_ns, seek_ns, step_ns, reread_ns = 0;
+	unsigned long i, frame;
+	long end = 0;
+
+	rand_state = 1;
+	input = make_animation(20000);
+	a = anim_open(input, cols, rows);
+
+	start = now_ns();
+	while (anim_read(a, end += PLAY_BYTES_PER_FRAME))
+		;
+	record_ns = now_ns() - start;
+
+	start = now_ns();
+	for (i = 0; i < PLAY_SEEKS; i++)
+		anim_seek(a, bench_rand() * a->nr_frames / 0x8000);
+	seek_ns = (now_ns() - start) / PLAY_SEEKS;
+
+	anim_seek(a, a->nr_frames - 1);
+	start = now_ns();
+	for (frame = a->nr_frames - 1; frame > 0; frame--)
+		anim_seek(a, frame - 1);
+	step_ns = (now_ns() - start) / (a->nr_frames - 1);
+
+	copy = fdopen(dup(fileno(input)), "rb");
+	if (!copy)
+		error("Could not open temporary file.");
+	for (i = 0; i < PLAY_REREADS; i++) {
+		struct edit_buffer * buf = edit_buffer_create(cols, rows);
+		struct ans_stream * stream;
+
+		frame = bench_rand() * a->nr_frames / 0x8000;
+		rewind(copy);
+		start = now_ns();
+		edit_buffer_clear(buf);
+		stream = ans_stream_open(copy, buf);
+		ans_stream_read(stream, a->frames[frame].offset);
+		reread_ns += now_ns() - start;
+		ans_stream_close(stream);
+		edit_buffer_release(buf);
+	}
+	fclose(copy);
+
+	printf("%-8s %9s %10s %10s %10s %10s %10s\n", "frames", "changes",
+	       "keyframes", "read ms", "seek us", "step us", "reread us");
+	printf("%-8lu %9lu %10lu %10.3f %10.3f %10.3f %10.3f\n", a->nr_frames,
+	       a->nr_changes, a->nr_keyframes, record_ns / 1e6, seek_ns / 1e3,
+	       step_ns / 1e3, reread_ns / 1e3 / PLAY_REREADS);
+
+	anim_release(a);
+	fclose(input);
+}
+
+static void usage(char * argv[])
+{
+	printf("usage: %s [-h -u -e -d -s -w -p -b <backend> -c <columns> -r <rows> "
+	       "-W <screen width> -H <screen height> -n <frames> "
+	       "-i <key interval us>]\n",
+	       argv[0]);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long canvas_cols = 80;
+	unsigned long canvas_rows = 10000;
+	unsigned long screen_width = 0;
+	unsigned long screen_height = 50;
+	const struct screen_backend * backend = &screen_mem_backend;
+	enum screen_charset charset = SCREEN_CHARSET_NATIVE;
+	bool export = false;
+	bool diff = false;
+	bool search = false;
+	bool reread = false;
+	bool play = false;
+
+	max_frames = 5000;
+
+	for (;;) {
+		int arg_index = getopt(argc, argv, "huedswpb:c:r:W:H:n:i:");
+		if (arg_index == -1) {
+			break;
+		}
+		switch (arg_index) {
+			case 'h':
+				usage(argv);
+				return EXIT_SUCCESS;
+			case 'u':
+				charset = SCREEN_CHARSET_UTF8;
+				break;
+			case 'e':
+				export = true;
+				break;
+			case 'd':
+				diff = true;
+				break;
+			case 's':
+				search = true;
+				break;
+			case 'w':
+				reread = true;
+				break;
+			case 'p':
+				play = true;
+				break;
+			case 'b':
+				backend = screen_backend_lookup(optarg);
+				if (!backend || backend == &screen_curses_backend) {
+					printf("backend '%s' can't run headless\n",
+					       optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+			case 'c':
+				canvas_cols = strtol(optarg, NULL, 10);
+				break;
+			case 'r':
+				canvas_rows = strtol(optarg, NULL, 10);
+				break;
+			case 'W':
+				screen_width = strtol(optarg, NULL, 10);
+				break;
+			case 'H':
+				screen_height = strtol(optarg, NULL, 10);
+				break;
+			case 'n':
+				max_frames = strtol(optarg, NULL, 10);
+				break;
+			case 'i':
+				key_interval_us = strtol(optarg, NULL, 10);
+				break;
+		default:
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+	}
+	if (screen_width == 0)
+		screen_width = canvas_cols;
+
+	if (export) {
+		bench_export(canvas_cols);
+		return EXIT_SUCCESS;
+	}
+
+	if (diff) {
+		bench_diff(canvas_cols, canvas_rows);
+		return EXIT_SUCCESS;
+	}
+
+	if (search) {
+		bench_search(canvas_cols, canvas_rows);
+		return EXIT_SUCCESS;
+	}
+
+	if (reread) {
+		bench_reread(canvas_cols, canvas_rows);
+		return EXIT_SUCCESS;
+	}
+
+	if (play) {
+		bench_play(canvas_cols, canvas_rows);
+		return EXIT_SUCCESS;
+	}
+
+	if (screen_height < 2 || screen_height > canvas_rows
+	    || screen_width > canvas_cols || max_frames == 0) {
+		usage(argv);
+		return EXIT_FAILURE;
+	}
+
+	nr_keys = max_frames;
+	frame_times = malloc(max_frames * sizeof(unsigned long));
+	latencies = malloc(nr_keys * sizeof(unsigned long));
+	if (!frame_times || !latencies)
+		error("Could not allocate memory for frame times.");
+
+	int null_fd = open("/dev/null", O_WRONLY);
+	if (null_fd < 0)
+		error("Could not open /dev/null.");
+	screen_set_headless(null_fd, screen_height, screen_width);
+
+	struct edit_buffer * buf = edit_buffer_create(canvas_cols, canvas_rows);
+
+	printf("%-8s %-8s %7s %10s %9s %9s %10s %10s\n",
+	       "backend", "session", "frames", "frames/s", "p50 us",
+	       "p99 us", "cells/fr", "bytes/fr");
+
+	char label[16];
+	snprintf(label, sizeof(label), "%s%s", backend->name,
+		 charset == SCREEN_CHARSET_UTF8 ? "-utf8" : "");
+
+	struct session * session;
+	for (session = sessions; session->name; session++) {
+		rand_state = 1;
+		fill_canvas(buf);
+		buf->start_x = buf->start_y = 0;
+
+		struct screen * scr = screen_init(backend, charset, canvas_cols);
+
+		/* First frame paints everything, keep it out of the
+		   numbers.  */
+		nr_frames = 0;
+		bench_frame(buf, scr);
+		memset(&screen_stats, 0, sizeof(screen_stats));
+		nr_frames = 0;
+
+		session->run(buf, scr);
+		report(label, session->name, &screen_stats);
+
+		screen_release(scr);
+	}
+
+	printf("\n%-8s %-8s %7s %10s %9s %9s %10s\n",
+	       "backend", "input", "keys", "frames", "p50 us", "p99 us",
+	       "max us");
+
+	int batched;
+	for (batched = 1; batched >= 0; batched--) {
+		struct screen * scr = screen_init(backend, charset, canvas_cols);
+
+		buf->start_y = 0;
+		bench_latency(label, buf, scr, batched);
+		screen_release(scr);
+	}
+
+	edit_buffer_release(buf);
+	close(null_fd);
+	free(frame_times);
+	free(latencies);
+
+	return EXIT_SUCCESS;
+}
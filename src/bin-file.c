@@ -36,14 +36,16 @@ void bin_file_read(FILE * input, struct edit_buffer * buf,
 {
 	unsigned long i = 0;
 	unsigned long column = 0;
+	unsigned long end = buf->width * buf->height;
 
-	while (!feof(input)) {
+	while (i < end && !feof(input)) {
 		int character = fgetc(input);
 		if (character == EOF)
 			break;
 		int attribute = fgetc(input);
+		/* A cell cut short ends the file like any other.  */
 		if (attribute == EOF)
-			error("premature end of file");
+			break;
 		buf->buffer[i++] = CHAR_ATTR_TO_INT(attribute, character);
 		column++;
 		if (column >= max_cols) {
@@ -51,4 +53,7 @@ void bin_file_read(FILE * input, struct edit_buffer * buf,
 			i += buf->width - max_cols;
 		}
 	}
+
+	if ((i + buf->width - 1) / buf->width > buf->max_height)
+		buf->max_height = (i + buf->width - 1) / buf->width;
 }
@@ -0,0 +1,880 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <dirent.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "browse.h"
+#include "colors.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "event-loop.h"
+#include "input.h"
+#include "keymap.h"
+#include "minimap.h"
+#include "screen.h"
+#include "search.h"
+
+/*
+ *	Browser
+ *
+ *	Shows the art in a directory as a grid of thumbnails.  Thumbnails
+ *	are decoded by a pool of worker threads, those on the screen first
+ *	and then a couple of screens ahead, and the screen is redrawn as
+ *	they come in.  Files that scrolled out of range before a worker got
+ *	to them are left alone until they come back.  Every thumbnail is
+ *	also kept in a cache file, so a directory seen before shows up at
+ *	once.
+ */
+
+#define THUMB_WIDTH	16
+#define THUMB_HEIGHT	10
+
+/* Each thumbnail cell is a half block for two rows of each half.  */
+#define SOURCE_WIDTH	80
+#define SOURCE_HEIGHT	(THUMB_HEIGHT * 4)
+
+/* A thumbnail with a column either side and the file name below.  */
+#define TILE_WIDTH	(THUMB_WIDTH + 2)
+#define TILE_HEIGHT	(THUMB_HEIGHT + 2)
+
+#define MAX_WORKERS	8
+#define PREFETCH_SCREENS 2
+
+#define STATUS_ATTR	COLOR_ATTR(7, 0)
+#define LABEL_ATTR	COLOR_ATTR(7, 0)
+#define SELECTED_ATTR	COLOR_ATTR(0, 7)
+#define WAITING_ATTR	COLOR_ATTR(8, 0)
+
+enum thumb_state {
+	THUMB_PENDING,
+	THUMB_DECODING,
+	THUMB_DONE,
+	THUMB_FAILED
+};
+
+struct browse_entry {
+	char * path;
+	const char * name;		/* in path */
+	off_t size;
+	struct timespec mtime;
+	enum thumb_state state;
+	unsigned int cells[THUMB_WIDTH * THUMB_HEIGHT];
+};
+
+struct browser {
+	char * dir;
+	browse_load_fn load;
+	char * cache_dir;		/* NULL if there is no cache */
+
+	struct browse_entry * entries;
+	unsigned long nr_entries;
+	unsigned long selected;
+	unsigned long top_row;		/* first row of tiles on the screen */
+
+	struct screen * scr;
+	struct edit_buffer * page;
+	unsigned long columns;		/* tiles across the screen */
+	unsigned long rows;		/* tiles down the screen */
+	char * chosen;
+	bool quit;
+	bool dirty;
+
+	/* The workers decode entries want_first to want_last, nearest to
+	   focus first.  Everything below is under lock.  */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t workers[MAX_WORKERS];
+	unsigned int nr_workers;
+	unsigned long want_first;
+	unsigned long want_last;
+	unsigned long focus;
+	bool stopping;
+	bool redraw_posted;
+};
+
+/*
+ *	Listing
+ */
+
+static int compare_entries(const void * a, const void * b)
+{
+	const struct browse_entry * x = a, * y = b;
+
+	return strcasecmp(x->name, y->name);
+}
+
+static void list_dir(struct browser * b)
+{
+	unsigned long max_entries = 0;
+	size_t dir_len = strlen(b->dir);
+	struct dirent * de;
+	DIR * dir;
+
+	dir = opendir(b->dir);
+	if (!dir)
+		return;
+
+	while ((de = readdir(dir))) {
+		struct browse_entry * e;
+		struct stat st;
+		char * path;
+
+		if (de->d_name[0] == '.' || !search_is_art(de->d_name))
+			continue;
+
+		path = malloc(dir_len + strlen(de->d_name) + 2);
+		if (!path)
+			error("Could not allocate memory for file name.");
+		sprintf(path, "%s/%s", b->dir, de->d_name);
+
+		if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+			free(path);
+			continue;
+		}
+
+		if (b->nr_entries == max_entries) {
+			max_entries = max_entries ? max_entries * 2 : 64;
+			b->entries = realloc(b->entries, max_entries
+					     * sizeof(struct browse_entry));
+			if (!b->entries)
+				error("Could not allocate memory for "
+				      "directory.");
+		}
+
+		e = &b->entries[b->nr_entries++];
+		memset(e, 0, sizeof(*e));
+		e->path = path;
+		e->name = path + dir_len + 1;
+		e->size = st.st_size;
+		e->mtime = st.st_mtim;
+		e->state = THUMB_PENDING;
+	}
+	closedir(dir);
+
+	if (b->nr_entries)
+		qsort(b->entries, b->nr_entries, sizeof(struct browse_entry),
+		      compare_entries);
+}
+
+/* Files changed while they were being edited are decoded again.  */
+static void recheck_entries(struct browser * b)
+{
+	unsigned long i;
+
+	for (i = 0; i < b->nr_entries; i++) {
+		struct browse_entry * e = &b->entries[i];
+		struct stat st;
+
+		if (stat(e->path, &st) != 0) {
+			e->state = THUMB_FAILED;
+			continue;
+		}
+		if (st.st_size != e->size
+		    || st.st_mtim.tv_sec != e->mtime.tv_sec
+		    || st.st_mtim.tv_nsec != e->mtime.tv_nsec) {
+			e->size = st.st_size;
+			e->mtime = st.st_mtim;
+			e->state = THUMB_PENDING;
+		}
+	}
+}
+
+/*
+ *	Thumbnails
+ *
+ *	A thumbnail cell stands for 5 columns and 4 rows of the top of the
+ *	piece, shrunk the way the minimap shrinks the canvas.
+ */
+
+static void make_thumb(struct browse_entry * e, struct edit_buffer * src)
+{
+	unsigned long tx, ty;
+
+	for (ty = 0; ty < THUMB_HEIGHT; ty++) {
+		for (tx = 0; tx < THUMB_WIDTH; tx++) {
+			unsigned long x0 = tx * SOURCE_WIDTH / THUMB_WIDTH;
+			unsigned long x1 = (tx + 1) * SOURCE_WIDTH
+					   / THUMB_WIDTH;
+
+			e->cells[ty * THUMB_WIDTH + tx] =
+				minimap_downsample(src, x0, ty * 4, x1 - x0, 4);
+		}
+	}
+}
+
+/*
+ *	Thumbnail cache
+ *
+ *	One file per piece under $XDG_CACHE_HOME/newdraw/thumbs, named by
+ *	a hash of its full path.  The file repeats the path, size and
+ *	modification time of the piece, and is only used if they still
+ *	match.
+ */
+
+#define CACHE_MAGIC	"NDTH"
+#define CACHE_VERSION	1
+
+struct cache_header {
+	char magic[4];
+	uint32_t version;
+	int64_t size;
+	int64_t mtime_sec;
+	int64_t mtime_nsec;
+	uint32_t path_len;
+};
+
+static bool make_dir(const char * path)
+{
+	return mkdir(path, 0755) == 0 || access(path, W_OK) == 0;
+}
+
+static char * cache_dir_init(void)
+{
+	const char * base = getenv("XDG_CACHE_HOME");
+	const char * home = getenv("HOME");
+	char * path;
+
+	if (!base || !*base) {
+		if (!home || !*home)
+			return NULL;
+		path = malloc(strlen(home) + sizeof("/.cache/newdraw/thumbs"));
+		if (!path)
+			error("Could not allocate memory for file name.");
+		sprintf(path, "%s/.cache", home);
+	} else {
+		path = malloc(strlen(base) + sizeof("/newdraw/thumbs"));
+		if (!path)
+			error("Could not allocate memory for file name.");
+		strcpy(path, base);
+	}
+
+	if (!make_dir(path))
+		goto fail;
+	strcat(path, "/newdraw");
+	if (!make_dir(path))
+		goto fail;
+	strcat(path, "/thumbs");
+	if (!make_dir(path))
+		goto fail;
+	return path;
+
+fail:
+	free(path);
+	return NULL;
+}
+
+/* FNV-1a, 64 bits.  */
+static uint64_t hash_path(const char * path)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	while (*path) {
+		hash ^= (unsigned char) *path++;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+static char * cache_file(struct browser * b, const char * full_path)
+{
+	char * path = malloc(strlen(b->cache_dir) + 1 + 16 + 1);
+
+	if (!path)
+		error("Could not allocate memory for file name.");
+	sprintf(path, "%s/%016llx", b->cache_dir,
+		(unsigned long long) hash_path(full_path));
+	return path;
+}
+
+static void cache_fill_header(struct cache_header * header,
+			      struct browse_entry * e, const char * full_path)
+{
+	memset(header, 0, sizeof(*header));
+	memcpy(header->magic, CACHE_MAGIC, 4);
+	header->version = CACHE_VERSION;
+	header->size = e->size;
+	header->mtime_sec = e->mtime.tv_sec;
+	header->mtime_nsec = e->mtime.tv_nsec;
+	header->path_len = strlen(full_path);
+}
+
+static bool cache_load(struct browser * b, struct browse_entry * e,
+		       const char * full_path)
+{
+	struct cache_header want, header;
+	char * path = cache_file(b, full_path);
+	char name[PATH_MAX];
+	FILE * input;
+	bool ok;
+
+	input = fopen(path, "rb");
+	free(path);
+	if (!input)
+		return false;
+
+	cache_fill_header(&want, e, full_path);
+	ok = fread(&header, sizeof(header), 1, input) == 1
+	     && memcmp(&header, &want, sizeof(header)) == 0
+	     && header.path_len < sizeof(name)
+	     && fread(name, 1, header.path_len, input) == header.path_len
+	     && memcmp(name, full_path, header.path_len) == 0
+	     && fread(e->cells, sizeof(e->cells), 1, input) == 1;
+	fclose(input);
+	return ok;
+}
+
+static void cache_store(struct browser * b, struct browse_entry * e,
+			const char * full_path)
+{
+	struct cache_header header;
+	char * path = cache_file(b, full_path);
+	char * tmp = malloc(strlen(path) + sizeof(".XXXXXX"));
+	FILE * output;
+	bool ok;
+	int fd;
+
+	if (!tmp)
+		error("Could not allocate memory for file name.");
+	sprintf(tmp, "%s.XXXXXX", path);
+
+	fd = mkstemp(tmp);
+	if (fd < 0)
+		goto out;
+	output = fdopen(fd, "wb");
+	if (!output) {
+		close(fd);
+		unlink(tmp);
+		goto out;
+	}
+
+	cache_fill_header(&header, e, full_path);
+	ok = fwrite(&header, sizeof(header), 1, output) == 1
+	     && fwrite(full_path, 1, header.path_len, output)
+		== header.path_len
+	     && fwrite(e->cells, sizeof(e->cells), 1, output) == 1;
+	if (fclose(output) != 0 || !ok || rename(tmp, path) != 0)
+		unlink(tmp);
+out:
+	free(tmp);
+	free(path);
+}
+
+static bool decode_thumb(struct browser * b, struct browse_entry * e,
+			 struct edit_buffer * src)
+{
+	char full_path[PATH_MAX];
+	bool cached = b->cache_dir && realpath(e->path, full_path);
+
+	if (cached && cache_load(b, e, full_path))
+		return true;
+
+	edit_buffer_clear(src);
+	if (!b->load(src, e->path))
+		return false;
+	make_thumb(e, src);
+
+	if (cached)
+		cache_store(b, e, full_path);
+	return true;
+}
+
+/*
+ *	Workers
+ */
+
+/* The pending entry in range nearest to the focus.  */
+static struct browse_entry * next_pending(struct browser * b)
+{
+	unsigned long d;
+
+	if (b->want_first > b->want_last)
+		return NULL;
+
+	for (d = 0; ; d++) {
+		bool in_range = false;
+
+		if (b->focus >= d && b->focus - d >= b->want_first) {
+			in_range = true;
+			if (b->entries[b->focus - d].state == THUMB_PENDING)
+				return &b->entries[b->focus - d];
+		}
+		if (b->focus + d <= b->want_last) {
+			in_range = true;
+			if (b->entries[b->focus + d].state == THUMB_PENDING)
+				return &b->entries[b->focus + d];
+		}
+		if (!in_range)
+			return NULL;
+	}
+}
+
+static void thumbs_ready(void * data)
+{
+	struct browser * b = data;
+
+	pthread_mutex_lock(&b->lock);
+	b->redraw_posted = false;
+	pthread_mutex_unlock(&b->lock);
+	b->dirty = true;
+}
+
+static void * worker_fn(void * data)
+{
+	struct browser * b = data;
+	struct edit_buffer * src;
+	struct browse_entry * e;
+
+	src = edit_buffer_create(SOURCE_WIDTH, SOURCE_HEIGHT);
+
+	pthread_mutex_lock(&b->lock);
+	for (;;) {
+		while (!b->stopping && !(e = next_pending(b)))
+			pthread_cond_wait(&b->cond, &b->lock);
+		if (b->stopping)
+			break;
+
+		e->state = THUMB_DECODING;
+		pthread_mutex_unlock(&b->lock);
+
+		bool ok = decode_thumb(b, e, src);
+
+		pthread_mutex_lock(&b->lock);
+		e->state = ok ? THUMB_DONE : THUMB_FAILED;
+
+		/* One redraw for however many come in before it.  */
+		if (!b->redraw_posted) {
+			b->redraw_posted = true;
+			event_loop_complete(thumbs_ready, b);
+		}
+	}
+	pthread_mutex_unlock(&b->lock);
+
+	edit_buffer_release(src);
+	return NULL;
+}
+
+static void workers_start(struct browser * b)
+{
+	long nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int i;
+
+	b->nr_workers = nr_cpus < 1 ? 1 : nr_cpus > MAX_WORKERS
+					  ? MAX_WORKERS : nr_cpus;
+	b->stopping = false;
+	b->redraw_posted = false;
+
+	for (i = 0; i < b->nr_workers; i++) {
+		if (pthread_create(&b->workers[i], NULL, worker_fn, b) != 0)
+			error("Could not create thumbnail thread.");
+	}
+}
+
+/* Thumbnails being decoded are finished first.  */
+static void workers_stop(struct browser * b)
+{
+	unsigned int i;
+
+	pthread_mutex_lock(&b->lock);
+	b->stopping = true;
+	pthread_cond_broadcast(&b->cond);
+	pthread_mutex_unlock(&b->lock);
+
+	for (i = 0; i < b->nr_workers; i++)
+		pthread_join(b->workers[i], NULL);
+	b->nr_workers = 0;
+}
+
+/* Point the workers at the screen and the screens after it.  */
+static void workers_retarget(struct browser * b)
+{
+	unsigned long per_screen = b->columns * b->rows;
+	unsigned long first = b->top_row * b->columns;
+
+	pthread_mutex_lock(&b->lock);
+	if (b->nr_entries == 0) {
+		b->want_first = 1;
+		b->want_last = 0;
+	} else {
+		b->want_first = first;
+		b->want_last = first + per_screen * (PREFETCH_SCREENS + 1) - 1;
+		if (b->want_last >= b->nr_entries)
+			b->want_last = b->nr_entries - 1;
+		b->focus = b->selected;
+	}
+	pthread_cond_broadcast(&b->cond);
+	pthread_mutex_unlock(&b->lock);
+}
+
+/*
+ *	Screen
+ */
+
+static void browse_layout(struct browser * b)
+{
+	b->columns = b->scr->width / TILE_WIDTH;
+	b->rows = b->scr->height / TILE_HEIGHT;
+	if (b->columns == 0)
+		b->columns = 1;
+	if (b->rows == 0)
+		b->rows = 1;
+
+	if (b->page)
+		edit_buffer_release(b->page);
+	b->page = edit_buffer_create(b->scr->width, b->scr->height);
+}
+
+static void scroll_to_selected(struct browser * b)
+{
+	unsigned long row = b->selected / b->columns;
+
+	if (row < b->top_row)
+		b->top_row = row;
+	if (row >= b->top_row + b->rows)
+		b->top_row = row - b->rows + 1;
+}
+
+static void page_put(struct edit_buffer * page, unsigned long x,
+		     unsigned long y, unsigned int cell)
+{
+	if (x < page->width && y < page->height)
+		page->buffer[y * page->width + x] = cell;
+}
+
+static void page_text(struct edit_buffer * page, unsigned long x,
+		      unsigned long y, int attr, const char * text,
+		      unsigned long len)
+{
+	unsigned long i;
+
+	for (i = 0; i < len; i++) {
+		unsigned char ch = *text ? *text++ : ' ';
+
+		page_put(page, x + i, y, CHAR_ATTR_TO_INT(attr, ch));
+	}
+}
+
+static void draw_tile(struct browser * b, struct browse_entry * e,
+		      unsigned long x, unsigned long y, bool selected)
+{
+	unsigned long tx, ty;
+
+	for (ty = 0; ty < THUMB_HEIGHT; ty++) {
+		for (tx = 0; tx < THUMB_WIDTH; tx++) {
+			unsigned int cell;
+
+			if (e->state == THUMB_DONE)
+				cell = e->cells[ty * THUMB_WIDTH + tx];
+			else
+				cell = CHAR_ATTR_TO_INT(WAITING_ATTR, 250);
+			page_put(b->page, x + tx, y + ty, cell);
+		}
+	}
+	if (e->state == THUMB_FAILED)
+		page_text(b->page, x + THUMB_WIDTH / 2 - 1, y + THUMB_HEIGHT / 2,
+			  WAITING_ATTR, "??", 2);
+
+	page_text(b->page, x, y + THUMB_HEIGHT,
+		  selected ? SELECTED_ATTR : LABEL_ATTR, e->name, THUMB_WIDTH);
+}
+
+static void browse_draw(struct browser * b)
+{
+	unsigned long first = b->top_row * b->columns;
+	unsigned long i, waiting = 0;
+	char status[256];
+
+	edit_buffer_clear(b->page);
+
+	pthread_mutex_lock(&b->lock);
+	for (i = first; i < b->nr_entries
+			&& i < first + b->columns * b->rows; i++) {
+		unsigned long col = (i - first) % b->columns;
+		unsigned long row = (i - first) / b->columns;
+
+		draw_tile(b, &b->entries[i], col * TILE_WIDTH + 1,
+			  row * TILE_HEIGHT, i == b->selected);
+		if (b->entries[i].state == THUMB_PENDING
+		    || b->entries[i].state == THUMB_DECODING)
+			waiting++;
+	}
+	pthread_mutex_unlock(&b->lock);
+
+	b->page->start_x = 0;
+	b->page->start_y = 0;
+	screen_draw_edit_buffer(b->scr, b->page);
+
+	if (b->nr_entries == 0)
+		snprintf(status, sizeof(status), " no art in %s", b->dir);
+	else if (waiting)
+		snprintf(status, sizeof(status), " %lu/%lu  %s  (decoding %lu)",
+			 b->selected + 1, b->nr_entries,
+			 b->entries[b->selected].name, waiting);
+	else
+		snprintf(status, sizeof(status), " %lu/%lu  %s",
+			 b->selected + 1, b->nr_entries,
+			 b->entries[b->selected].name);
+	screen_draw_text(b->scr, b->scr->height, 0, STATUS_ATTR, status,
+			 b->scr->width);
+
+	screen_move(b->scr->height, 0);
+	screen_refresh();
+}
+
+/*
+ *	Commands
+ *
+ *	Like the viewer, the browser follows the keymap for the editor's
+ *	movement commands.  Enter opens the selected file.
+ */
+
+static void browse_left(struct browser * b)
+{
+	if (b->selected > 0)
+		b->selected--;
+}
+
+static void browse_right(struct browser * b)
+{
+	if (b->selected + 1 < b->nr_entries)
+		b->selected++;
+}
+
+static void browse_up(struct browser * b)
+{
+	if (b->selected >= b->columns)
+		b->selected -= b->columns;
+}
+
+static void browse_down(struct browser * b)
+{
+	if (b->selected + b->columns < b->nr_entries)
+		b->selected += b->columns;
+}
+
+static void browse_page_up(struct browser * b)
+{
+	unsigned long step = b->columns * b->rows;
+
+	b->selected = b->selected > step ? b->selected - step
+					 : b->selected % b->columns;
+}
+
+static void browse_page_down(struct browser * b)
+{
+	unsigned long step = b->columns * b->rows;
+
+	if (b->selected + step < b->nr_entries)
+		b->selected += step;
+	else if (b->nr_entries)
+		b->selected = b->nr_entries - 1;
+}
+
+static void browse_start(struct browser * b)
+{
+	b->selected = 0;
+}
+
+static void browse_end(struct browser * b)
+{
+	if (b->nr_entries)
+		b->selected = b->nr_entries - 1;
+}
+
+static void browse_quit(struct browser * b)
+{
+	b->quit = true;
+}
+
+static void browse_open(struct browser * b)
+{
+	if (b->nr_entries == 0)
+		return;
+
+	b->chosen = strdup(b->entries[b->selected].path);
+	if (!b->chosen)
+		error("Could not allocate memory for file name.");
+	b->quit = true;
+}
+
+static void browse_resize(void * data)
+{
+	struct browser * b = data;
+
+	screen_resize(b->scr);
+	browse_layout(b);
+	scroll_to_selected(b);
+	workers_retarget(b);
+	screen_redraw();
+	b->dirty = true;
+}
+
+static void browse_resize_key(struct browser * b)
+{
+	browse_resize(b);
+}
+
+static const struct {
+	const char * command;
+	void (*fn)(struct browser *);
+} browse_commands[] = {
+	{ "move_left",		browse_left },
+	{ "move_right",		browse_right },
+	{ "move_up",		browse_up },
+	{ "move_down",		browse_down },
+	{ "page_up",		browse_page_up },
+	{ "page_down",		browse_page_down },
+	{ "move_to_start",	browse_start },
+	{ "move_to_end",	browse_end },
+	{ "resize",		browse_resize_key },
+	{ "quit",		browse_quit }
+};
+
+#define NR_BROWSE_COMMANDS \
+	(sizeof(browse_commands) / sizeof(browse_commands[0]))
+
+static void browse_key(struct browser * b, int key)
+{
+	const char * name = keymap_lookup(key)->name;
+	unsigned long i;
+
+	if (key == ERR)
+		error("Could not read key from terminal.");
+
+	if (key == '\r' || key == '\n' || key == KEY_ENTER) {
+		browse_open(b);
+		return;
+	}
+
+	for (i = 0; i < NR_BROWSE_COMMANDS; i++) {
+		if (strcmp(browse_commands[i].command, name) == 0) {
+			browse_commands[i].fn(b);
+			return;
+		}
+	}
+}
+
+static void browse_input(int fd, short revents, void * data)
+{
+	struct browser * b = data;
+	struct input_event event;
+	bool got_key = false;
+
+	while (!b->quit && input_poll()) {
+		while (!b->quit && input_next_event(&event))
+			browse_key(b, event.key);
+		got_key = true;
+	}
+
+	if (!got_key && (revents & (POLLERR | POLLHUP)))
+		error("Could not read key from terminal.");
+
+	scroll_to_selected(b);
+	workers_retarget(b);
+	b->dirty = true;
+}
+
+struct browser * browser_create(const char * dir, browse_load_fn load)
+{
+	struct browser * b = calloc(1, sizeof(struct browser));
+
+	if (!b)
+		error("Could not allocate memory for browser.");
+
+	b->dir = strdup(dir);
+	if (!b->dir)
+		error("Could not allocate memory for file name.");
+	b->load = load;
+	b->cache_dir = cache_dir_init();
+	pthread_mutex_init(&b->lock, NULL);
+	pthread_cond_init(&b->cond, NULL);
+
+	list_dir(b);
+	return b;
+}
+
+void browser_release(struct browser * b)
+{
+	unsigned long i;
+
+	for (i = 0; i < b->nr_entries; i++)
+		free(b->entries[i].path);
+	free(b->entries);
+	pthread_cond_destroy(&b->cond);
+	pthread_mutex_destroy(&b->lock);
+	free(b->cache_dir);
+	free(b->dir);
+	free(b);
+}
+
+char * browser_run(struct browser * b, const struct screen_backend * backend,
+		   enum screen_charset charset)
+{
+	char * chosen;
+
+	recheck_entries(b);
+
+	/* Before the screen so that the event loop gets SIGWINCH.  */
+	event_loop_init();
+
+	b->scr = screen_init(backend, charset, ULONG_MAX);
+	browse_layout(b);
+	scroll_to_selected(b);
+	workers_retarget(b);
+	workers_start(b);
+
+	input_start();
+	event_loop_watch_fd(input_fd(), browse_input, b);
+	event_loop_on_resize(browse_resize, b);
+
+	b->quit = false;
+	b->dirty = true;
+	while (!b->quit) {
+		if (b->dirty) {
+			browse_draw(b);
+			b->dirty = false;
+		}
+		event_loop_run_once();
+	}
+
+	event_loop_on_resize(NULL, NULL);
+	event_loop_unwatch_fd(input_fd());
+	input_stop();
+	workers_stop(b);
+
+	edit_buffer_release(b->page);
+	b->page = NULL;
+	screen_release(b->scr);
+	b->scr = NULL;
+	/* Runs the redraws still queued, which only set dirty.  */
+	event_loop_release();
+
+	chosen = b->chosen;
+	b->chosen = NULL;
+	return chosen;
+}
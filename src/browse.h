@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _BROWSE_H
+#define _BROWSE_H 1
+
+#include "screen.h"
+
+struct browser;
+struct edit_buffer;
+
+/* Returns false if the file could not be read.  */
+typedef bool (*browse_load_fn)(struct edit_buffer *, const char *);
+
+struct browser * browser_create(const char *, browse_load_fn);
+void browser_release(struct browser *);
+
+/* Returns the file to open, or NULL when the user quits.  */
+char * browser_run(struct browser *, const struct screen_backend *,
+		   enum screen_charset);
+
+#endif
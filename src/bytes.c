@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bytes.h"
+#include "error.h"
+
+void bytes_reserve(struct bytes * b, unsigned long len)
+{
+	if (b->len + len <= b->size)
+		return;
+
+	while (b->len + len > b->size)
+		b->size = b->size ? b->size * 2 : 4096;
+
+	b->data = realloc(b->data, b->size);
+	if (!b->data)
+		error("Could not allocate memory for buffer.");
+}
+
+void bytes_put(struct bytes * b, const void * data, unsigned long len)
+{
+	bytes_reserve(b, len);
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+}
+
+void bytes_put_varint(struct bytes * b, unsigned long long value)
+{
+	bytes_reserve(b, 10);
+	while (value >= 0x80) {
+		b->data[b->len++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	b->data[b->len++] = value;
+}
+
+bool bytes_get_varint(struct byte_reader * r, unsigned long long * value)
+{
+	unsigned int shift = 0;
+
+	*value = 0;
+	for (;;) {
+		if (r->pos == r->len || shift > 63)
+			return false;
+
+		unsigned char ch = r->data[r->pos++];
+		*value |= (unsigned long long) (ch & 0x7F) << shift;
+		if (!(ch & 0x80))
+			return true;
+		shift += 7;
+	}
+}
+
+unsigned int bytes_checksum(const unsigned char * data, unsigned long len)
+{
+	unsigned int hash = 0x811C9DC5;
+	unsigned long i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= data[i];
+		hash *= 0x01000193;
+	}
+	return hash;
+}
+
+/* The whole file, or NULL if it cannot be read or is empty.  */
+unsigned char * bytes_read_file(const char * path, unsigned long * len)
+{
+	unsigned char * data = NULL;
+	struct stat st;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) == 0 && st.st_size > 0) {
+		data = malloc(st.st_size);
+		if (!data)
+			error("Could not allocate memory for file.");
+
+		*len = 0;
+		while (*len < st.st_size) {
+			ssize_t ret = read(fd, data + *len, st.st_size - *len);
+
+			if (ret <= 0)
+				break;
+			*len += ret;
+		}
+	}
+	close(fd);
+	return data;
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _BYTES_H
+#define _BYTES_H 1
+
+#include <stdbool.h>
+
+/*
+ *	Byte strings for the binary file formats: a growable buffer to
+ *	build them in, a reader to take them apart again, unsigned LEB128
+ *	varints and a 32-bit FNV-1a checksum.
+ */
+
+struct bytes {
+	unsigned char * data;
+	unsigned long len;
+	unsigned long size;
+};
+
+struct byte_reader {
+	const unsigned char * data;
+	unsigned long len;
+	unsigned long pos;
+};
+
+void bytes_reserve(struct bytes *, unsigned long);
+void bytes_put(struct bytes *, const void *, unsigned long);
+void bytes_put_varint(struct bytes *, unsigned long long);
+bool bytes_get_varint(struct byte_reader *, unsigned long long *);
+unsigned int bytes_checksum(const unsigned char *, unsigned long);
+unsigned char * bytes_read_file(const char *, unsigned long *);
+
+#endif
@@ -0,0 +1,404 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "bytes.h"
+#include "cell-diff.h"
+#include "edit-buffer.h"
+#include "error.h"
+
+/*
+ *	Cell diff
+ *
+ *	Rows are compared a vector at a time, 32 bytes (eight cells) with
+ *	AVX2 or 16 bytes with SSE2, so identical spans cost little more
+ *	than reading them.  The changed cells of a row are gathered into
+ *	runs, bridging gaps of up to DIFF_MERGE_GAP equal cells, and runs
+ *	that touch a rectangle open on the row above grow it.  Rectangles
+ *	the current row leaves alone are closed.
+ */
+
+#define DIFF_MERGE_GAP 4
+
+/* Index of the first cell from i on where a and b differ, or n.  */
+unsigned long cell_diff_first(const unsigned int * a, const unsigned int * b,
+			      unsigned long i, unsigned long n)
+{
+#if defined(__AVX2__)
+	for (; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_loadu_si256((const __m256i *) (a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (b + i));
+		unsigned int same = _mm256_movemask_epi8(
+					_mm256_cmpeq_epi32(x, y));
+
+		if (same != 0xFFFFFFFF)
+			return i + __builtin_ctz(~same) / 4;
+	}
+#elif defined(__SSE2__)
+	for (; i + 4 <= n; i += 4) {
+		__m128i x = _mm_loadu_si128((const __m128i *) (a + i));
+		__m128i y = _mm_loadu_si128((const __m128i *) (b + i));
+		unsigned int same = _mm_movemask_epi8(_mm_cmpeq_epi32(x, y));
+
+		if (same != 0xFFFF)
+			return i + __builtin_ctz(~same) / 4;
+	}
+#endif
+	for (; i < n; i++) {
+		if (a[i] != b[i])
+			break;
+	}
+	return i;
+}
+
+/* Changed runs are short, so the end of one is looked for a cell at a
+   time.  */
+static unsigned long first_same(const unsigned int * a,
+				const unsigned int * b, unsigned long i,
+				unsigned long n)
+{
+	for (; i < n; i++) {
+		if (a[i] == b[i])
+			break;
+	}
+	return i;
+}
+
+struct diff_state {
+	struct cell_diff * diff;
+	unsigned long * open;		/* rects on the row above */
+	unsigned long nr_open;
+	unsigned long * next;		/* rects on this row */
+	unsigned long nr_next;
+};
+
+static unsigned long new_rect(struct cell_diff * diff, unsigned long x,
+			      unsigned long y, unsigned long width)
+{
+	struct diff_rect * rect;
+
+	if (diff->nr_rects == diff->max_rects) {
+		diff->max_rects = diff->max_rects ? diff->max_rects * 2 : 64;
+		diff->rects = realloc(diff->rects, diff->max_rects
+				      * sizeof(struct diff_rect));
+		if (!diff->rects)
+			error("Could not allocate memory for diff.");
+	}
+
+	rect = &diff->rects[diff->nr_rects];
+	rect->x = x;
+	rect->y = y;
+	rect->width = width;
+	rect->height = 1;
+	return diff->nr_rects++;
+}
+
+static bool touches(struct diff_rect * rect, unsigned long x,
+		    unsigned long end)
+{
+	return x <= rect->x + rect->width + DIFF_MERGE_GAP
+	       && rect->x <= end + DIFF_MERGE_GAP;
+}
+
+/* Grow rect to take in the other one, which is left empty.  */
+static void absorb(struct diff_rect * rect, struct diff_rect * other)
+{
+	unsigned long right = rect->x + rect->width;
+	unsigned long bottom = rect->y + rect->height;
+
+	if (other->x + other->width > right)
+		right = other->x + other->width;
+	if (other->y + other->height > bottom)
+		bottom = other->y + other->height;
+	if (other->x < rect->x)
+		rect->x = other->x;
+	if (other->y < rect->y)
+		rect->y = other->y;
+	rect->width = right - rect->x;
+	rect->height = bottom - rect->y;
+	other->width = 0;
+}
+
+static void add_run(struct diff_state * s, unsigned long y, unsigned long x,
+		    unsigned long end)
+{
+	struct cell_diff * diff = s->diff;
+	struct diff_rect run = { x, y, end - x, 1 };
+	unsigned long grown = diff->nr_rects;
+	unsigned long i;
+
+	/* Everything the run touches, on this row or the one above,
+	   becomes one rectangle.  */
+	for (i = 0; i < s->nr_open; i++) {
+		struct diff_rect * rect = &diff->rects[s->open[i]];
+
+		if (s->open[i] == grown || rect->width == 0
+		    || !touches(rect, x, end))
+			continue;
+		if (grown == diff->nr_rects) {
+			grown = s->open[i];
+			absorb(rect, &run);
+			s->next[s->nr_next++] = grown;
+		} else
+			absorb(&diff->rects[grown], rect);
+	}
+	for (i = 0; i < s->nr_next; i++) {
+		struct diff_rect * rect = &diff->rects[s->next[i]];
+
+		if (s->next[i] == grown || rect->width == 0
+		    || !touches(rect, x, end))
+			continue;
+		if (grown == diff->nr_rects) {
+			grown = s->next[i];
+			absorb(rect, &run);
+		} else
+			absorb(&diff->rects[grown], rect);
+	}
+
+	if (grown == diff->nr_rects)
+		s->next[s->nr_next++] = new_rect(diff, x, y, end - x);
+}
+
+/* Rectangles merged into others are dropped, keeping the order.  */
+static void drop_empty(struct cell_diff * diff)
+{
+	unsigned long i, j = 0;
+
+	for (i = 0; i < diff->nr_rects; i++) {
+		if (diff->rects[i].width)
+			diff->rects[j++] = diff->rects[i];
+	}
+	diff->nr_rects = j;
+}
+
+void cell_diff(struct edit_buffer * a, struct edit_buffer * b,
+	       struct cell_diff * diff)
+{
+	unsigned long width = a->width;
+	struct diff_state s;
+	unsigned long * lists;
+	unsigned long y;
+
+	memset(diff, 0, sizeof(*diff));
+	memset(&s, 0, sizeof(s));
+	s.diff = diff;
+	/* A row has at most one run per two cells.  */
+	lists = malloc((width / 2 + 1) * 2 * sizeof(unsigned long));
+	if (!lists)
+		error("Could not allocate memory for diff.");
+	s.open = lists;
+	s.next = lists + width / 2 + 1;
+
+	for (y = 0; y < a->height; y++) {
+		const unsigned int * row_a = &a->buffer[y * width];
+		const unsigned int * row_b = &b->buffer[y * width];
+		unsigned long x = cell_diff_first(row_a, row_b, 0, width);
+		unsigned long * swap;
+
+		s.nr_next = 0;
+		while (x < width) {
+			unsigned long end = first_same(row_a, row_b, x, width);
+			unsigned long next;
+
+			diff->nr_cells += end - x;
+			next = cell_diff_first(row_a, row_b, end, width);
+			while (next < width && next - end <= DIFF_MERGE_GAP) {
+				end = first_same(row_a, row_b, next, width);
+				diff->nr_cells += end - next;
+				next = cell_diff_first(row_a, row_b, end,
+						       width);
+			}
+			add_run(&s, y, x, end);
+			x = next;
+		}
+
+		swap = s.open;
+		s.open = s.next;
+		s.next = swap;
+		s.nr_open = s.nr_next;
+	}
+
+	free(lists);
+	drop_empty(diff);
+}
+
+void cell_diff_release(struct cell_diff * diff)
+{
+	free(diff->rects);
+	memset(diff, 0, sizeof(*diff));
+}
+
+/*
+ *	Patch format
+ *
+ *	"NDPT", then as varints the version, the canvas size, the hashes
+ *	of the canvas before and after and the number of rectangles.  Each
+ *	rectangle is its position and size followed by its cells in the
+ *	new canvas, row by row, as runs of length and cell.  A 32-bit
+ *	FNV-1a checksum of everything before it ends the patch.
+ */
+
+#define PATCH_MAGIC "NDPT"
+#define PATCH_MAGIC_LEN 4
+#define PATCH_VERSION 2
+
+static void encode_rect(struct bytes * out, struct edit_buffer * buf,
+			struct diff_rect * rect)
+{
+	unsigned long nr_cells = rect->width * rect->height;
+	unsigned long i, run;
+
+	bytes_put_varint(out, rect->x);
+	bytes_put_varint(out, rect->y);
+	bytes_put_varint(out, rect->width);
+	bytes_put_varint(out, rect->height);
+
+	for (i = 0; i < nr_cells; i += run) {
+		unsigned int cell = edit_buffer_get(buf,
+					rect->x + i % rect->width,
+					rect->y + i / rect->width);
+
+		for (run = 1; i + run < nr_cells; run++) {
+			if (edit_buffer_get(buf,
+					rect->x + (i + run) % rect->width,
+					rect->y + (i + run) / rect->width)
+			    != cell)
+				break;
+		}
+		bytes_put_varint(out, run);
+		bytes_put_varint(out, cell);
+	}
+}
+
+/* A patch that turns canvas a into canvas b.  */
+bool patch_write(FILE * output, struct edit_buffer * a,
+		 struct edit_buffer * b, struct cell_diff * diff)
+{
+	struct bytes out = { NULL, 0, 0 };
+	unsigned int sum;
+	unsigned long i;
+	bool ok;
+
+	bytes_put(&out, PATCH_MAGIC, PATCH_MAGIC_LEN);
+	bytes_put_varint(&out, PATCH_VERSION);
+	bytes_put_varint(&out, a->width);
+	bytes_put_varint(&out, a->height);
+	bytes_put_varint(&out, edit_buffer_hash(a));
+	bytes_put_varint(&out, edit_buffer_hash(b));
+	bytes_put_varint(&out, diff->nr_rects);
+
+	for (i = 0; i < diff->nr_rects; i++)
+		encode_rect(&out, b, &diff->rects[i]);
+
+	sum = bytes_checksum(out.data, out.len);
+	unsigned char sum_bytes[4] = {
+		sum, sum >> 8, sum >> 16, sum >> 24
+	};
+	bytes_put(&out, sum_bytes, 4);
+
+	ok = fwrite(out.data, 1, out.len, output) == out.len;
+	free(out.data);
+	return ok;
+}
+
+static bool apply_rect(struct byte_reader * r, struct edit_buffer * buf)
+{
+	unsigned long long x, y, width, height, run, cell;
+	unsigned long i = 0, nr_cells;
+
+	if (!bytes_get_varint(r, &x) || !bytes_get_varint(r, &y)
+	    || !bytes_get_varint(r, &width) || !bytes_get_varint(r, &height)
+	    || x > buf->width || width > buf->width - x
+	    || y > buf->height || height > buf->height - y)
+		return false;
+
+	nr_cells = width * height;
+	while (i < nr_cells) {
+		if (!bytes_get_varint(r, &run) || !bytes_get_varint(r, &cell)
+		    || run > nr_cells - i)
+			return false;
+
+		for (; run > 0; run--, i++)
+			edit_buffer_put(buf, x + i % width, y + i / width,
+					cell);
+	}
+	return true;
+}
+
+/* Apply the patch in data to buf.  The rectangles go to a copy of buf
+   that replaces it only once the result hashes to the canvas the patch
+   was made to, so buf is left as it was unless PATCH_APPLIED.  */
+enum patch_status patch_apply(const unsigned char * data, unsigned long len,
+			      struct edit_buffer * buf)
+{
+	unsigned long long version, width, height, before, after, nr_rects;
+	struct byte_reader r = { data, len, PATCH_MAGIC_LEN };
+	const unsigned char * sum;
+	struct edit_buffer * copy;
+	unsigned int * cells;
+
+	if (len < PATCH_MAGIC_LEN + 4
+	    || memcmp(data, PATCH_MAGIC, PATCH_MAGIC_LEN) != 0)
+		return PATCH_CORRUPT;
+
+	sum = data + len - 4;
+	r.len = len - 4;
+	if (bytes_checksum(data, r.len) != (sum[0] | sum[1] << 8
+					    | sum[2] << 16
+					    | (unsigned int) sum[3] << 24))
+		return PATCH_CORRUPT;
+
+	if (!bytes_get_varint(&r, &version) || version != PATCH_VERSION
+	    || !bytes_get_varint(&r, &width) || !bytes_get_varint(&r, &height)
+	    || !bytes_get_varint(&r, &before) || !bytes_get_varint(&r, &after)
+	    || !bytes_get_varint(&r, &nr_rects))
+		return PATCH_CORRUPT;
+
+	if (width != buf->width || height != buf->height
+	    || before != edit_buffer_hash(buf))
+		return PATCH_MISMATCH;
+
+	copy = edit_buffer_clone(buf);
+	while (nr_rects-- > 0) {
+		if (!apply_rect(&r, copy)) {
+			edit_buffer_release(copy);
+			return PATCH_CORRUPT;
+		}
+	}
+
+	if (edit_buffer_hash(copy) != after) {
+		edit_buffer_release(copy);
+		return PATCH_CORRUPT;
+	}
+
+	cells = buf->buffer;
+	buf->buffer = copy->buffer;
+	buf->max_height = copy->max_height;
+	buf->dirty_from = copy->dirty_from;
+	buf->changed_from = copy->changed_from;
+	buf->changed_to = copy->changed_to;
+	copy->buffer = cells;
+	edit_buffer_release(copy);
+	return PATCH_APPLIED;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _CELL_DIFF_H
+#define _CELL_DIFF_H 1
+
+#include <stdbool.h>
+#include <stdio.h>
+
+struct edit_buffer;
+
+/*
+ *	Differences between two canvases of the same size, as rectangles
+ *	covering every cell that differs.  Rectangles are in the order of
+ *	their top rows.
+ */
+
+struct diff_rect {
+	unsigned long x;
+	unsigned long y;
+	unsigned long width;
+	unsigned long height;
+};
+
+struct cell_diff {
+	unsigned long nr_rects;
+	unsigned long max_rects;
+	struct diff_rect * rects;
+	unsigned long nr_cells;		/* that differ */
+};
+
+void cell_diff(struct edit_buffer *, struct edit_buffer *,
+	       struct cell_diff *);
+void cell_diff_release(struct cell_diff *);
+unsigned long cell_diff_first(const unsigned int *, const unsigned int *,
+			      unsigned long, unsigned long);
+
+enum patch_status {
+	PATCH_APPLIED,
+	PATCH_CORRUPT,			/* or not a patch */
+	PATCH_MISMATCH			/* made against a different canvas */
+};
+
+bool patch_write(FILE *, struct edit_buffer *, struct edit_buffer *,
+		 struct cell_diff *);
+enum patch_status patch_apply(const unsigned char *, unsigned long,
+			      struct edit_buffer *);
+
+#endif
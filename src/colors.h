@@ -9,7 +9,28 @@
 
 #define COLOR_ATTR(fg, bg) (bg * 0x10 + fg)
 
-int attr_to_color_pair (int fg_color, int bg_color);
-void init_color_pairs ();
+extern const unsigned char vga_palette[16][3];
+
+/* Curses color pair of each attribute, -1 until it is first drawn.  */
+extern short color_pair_cache[256];
+extern unsigned long color_pair_frame;
+extern unsigned long color_pair_drawn[256];
+
+void init_color_pairs(void);
+int color_pair_make(int);
+
+static inline int color_pair(int attr)
+{
+	color_pair_drawn[attr] = color_pair_frame;
+	if (color_pair_cache[attr] >= 0)
+		return color_pair_cache[attr];
+	return color_pair_make(attr);
+}
+
+/* Pairs drawn before the next frame were not drawn in this one.  */
+static inline void color_pairs_next_frame(void)
+{
+	color_pair_frame++;
+}
 
 #endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdbool.h>
+
+#include "cp437.h"
+
+/*
+ *	IBM CP437 to Unicode mapping.  The control character range has
+ *	the glyphs the VGA font shows for them.
+ */
+const unsigned short cp437_to_unicode[256] = {
+	0x0020, 0x263A, 0x263B, 0x2665, 0x2666, 0x2663, 0x2660, 0x2022,   /* 00 */
+	0x25D8, 0x25CB, 0x25D9, 0x2642, 0x2640, 0x266A, 0x266B, 0x263C,   /* 08 */
+	0x25BA, 0x25C4, 0x2195, 0x203C, 0x00B6, 0x00A7, 0x25AC, 0x21A8,   /* 10 */
+	0x2191, 0x2193, 0x2192, 0x2190, 0x221F, 0x2194, 0x25B2, 0x25BC,   /* 18 */
+	0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027,   /* 20 */
+	0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,   /* 28 */
+	0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,   /* 30 */
+	0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,   /* 38 */
+	0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,   /* 40 */
+	0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,   /* 48 */
+	0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,   /* 50 */
+	0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F,   /* 58 */
+	0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,   /* 60 */
+	0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,   /* 68 */
+	0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,   /* 70 */
+	0x0078, 0x0079, 0x007A, 0x007B, 0x007C, 0x007D, 0x007E, 0x2302,   /* 78 */
+	0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,   /* 80 */
+	0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,   /* 88 */
+	0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,   /* 90 */
+	0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,   /* 98 */
+	0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,   /* A0 */
+	0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,   /* A8 */
+	0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,   /* B0 */
+	0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,   /* B8 */
+	0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F,   /* C0 */
+	0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,   /* C8 */
+	0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,   /* D0 */
+	0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,   /* D8 */
+	0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4,   /* E0 */
+	0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,   /* E8 */
+	0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248,   /* F0 */
+	0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0,   /* F8 */
+};
+
+/*
+ *	Output encoding for each character, built once at startup so
+ *	that drawing a cell is a table lookup.
+ */
+struct cp437_glyph cp437_glyphs[256];
+
+bool cp437_utf8 = false;
+
+static unsigned int utf8_encode(char * dst, unsigned int code)
+{
+	if (code < 0x80) {
+		dst[0] = code;
+		return 1;
+	}
+	if (code < 0x800) {
+		dst[0] = 0xC0 | (code >> 6);
+		dst[1] = 0x80 | (code & 0x3F);
+		return 2;
+	}
+	dst[0] = 0xE0 | (code >> 12);
+	dst[1] = 0x80 | ((code >> 6) & 0x3F);
+	dst[2] = 0x80 | (code & 0x3F);
+	return 3;
+}
+
+void cp437_init(bool utf8)
+{
+	int ch;
+
+	cp437_utf8 = utf8;
+
+	for (ch = 0; ch < 256; ch++) {
+		struct cp437_glyph * glyph = &cp437_glyphs[ch];
+
+		if (utf8) {
+			glyph->len = utf8_encode(glyph->bytes,
+						 cp437_to_unicode[ch]);
+			continue;
+		}
+
+		/* Control characters would be interpreted by the
+		   terminal.  */
+		if (ch < 0x20 || ch == 0x7F)
+			glyph->bytes[0] = '^';
+		else
+			glyph->bytes[0] = ch;
+		glyph->len = 1;
+	}
+}
+
+/*
+ *	UTF-8 for every character whatever the terminal takes, for the
+ *	exporters.
+ */
+static struct cp437_glyph utf8_glyphs[256];
+static bool utf8_glyphs_built = false;
+
+const struct cp437_glyph * cp437_utf8_glyphs(void)
+{
+	int ch;
+
+	if (utf8_glyphs_built)
+		return utf8_glyphs;
+
+	for (ch = 0; ch < 256; ch++)
+		utf8_glyphs[ch].len = utf8_encode(utf8_glyphs[ch].bytes,
+						  cp437_to_unicode[ch]);
+	utf8_glyphs_built = true;
+	return utf8_glyphs;
+}
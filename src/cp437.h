@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _CP437_H
+#define _CP437_H 1
+
+#include <stdbool.h>
+
+/* Bytes to send to the terminal for a CP437 character.  */
+struct cp437_glyph {
+	char bytes[4];
+	unsigned int len;
+};
+
+extern const unsigned short cp437_to_unicode[256];
+extern struct cp437_glyph cp437_glyphs[256];
+extern bool cp437_utf8;
+
+void cp437_init(bool);
+const struct cp437_glyph * cp437_utf8_glyphs(void);
+
+#endif
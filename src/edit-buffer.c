@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "edit-buffer.h"
 #include "error.h"
@@ -35,6 +36,12 @@ void edit_buffer_put(struct edit_buffer *buf, unsigned long x,
 
 	if (y + 1 > buf->max_height)
 		buf->max_height = y + 1;
+	if (y < buf->dirty_from)
+		buf->dirty_from = y;
+	if (y < buf->changed_from)
+		buf->changed_from = y;
+	if (y + 1 > buf->changed_to)
+		buf->changed_to = y + 1;
 }
 
 int edit_buffer_get(struct edit_buffer *buf, unsigned long x,
@@ -51,14 +58,30 @@ int edit_buffer_get(struct edit_buffer *buf, unsigned long x,
 void edit_buffer_clear(struct edit_buffer *buf)
 
 {
-	int x, y;
+	unsigned long i;
+
+	for (i = 0; i < buf->height * buf->width; i++)
+		buf->buffer[i] = 0x0720;
 
-	for (y = 0; y < buf->height; y++) {
-		for (x = 0; x < buf->width; x++) {
-			edit_buffer_put(buf, x, y, 0x0720);
-		}
-	}
 	buf->max_height = 0;
+	buf->dirty_from = 0;
+	buf->changed_from = 0;
+	buf->changed_to = buf->height;
+}
+
+/* The rows from..to-1 take in every row changed since the last call.
+   Returns false if no row changed.  */
+bool edit_buffer_take_changes(struct edit_buffer * buf, unsigned long * from,
+			      unsigned long * to)
+{
+	if (buf->changed_from >= buf->changed_to)
+		return false;
+
+	*from = buf->changed_from;
+	*to = buf->changed_to;
+	buf->changed_from = buf->height;
+	buf->changed_to = 0;
+	return true;
 }
 
 struct edit_buffer * edit_buffer_create(unsigned long width,
@@ -73,12 +96,50 @@ struct edit_buffer * edit_buffer_create(unsigned long width,
 	ret->height = height;
 	ret->width = width;
 	ret->max_height = 0;
+	ret->dirty_from = 0;
+	ret->changed_from = 0;
+	ret->changed_to = height;
 	ret->start_x = 0;
 	ret->start_y = 0;
 
 	return ret;
 }
 
+/* Copy of the buffer contents, for working on a snapshot.  */
+struct edit_buffer * edit_buffer_clone(struct edit_buffer * buf)
+{
+	struct edit_buffer * ret = edit_buffer_create(buf->width, buf->height);
+
+	memcpy(ret->buffer, buf->buffer,
+	       buf->height * buf->width * sizeof(int));
+	ret->max_height = buf->max_height;
+	ret->dirty_from = buf->dirty_from;
+	ret->changed_from = buf->changed_from;
+	ret->changed_to = buf->changed_to;
+	ret->start_x = buf->start_x;
+	ret->start_y = buf->start_y;
+
+	return ret;
+}
+
+/* FNV-1a over all cells, for telling whether two canvases match.  */
+unsigned long long edit_buffer_hash(struct edit_buffer * buf)
+{
+	unsigned long long hash = 0xCBF29CE484222325ULL;
+	unsigned long i;
+
+	for (i = 0; i < buf->height * buf->width; i++) {
+		unsigned int cell = buf->buffer[i];
+		int byte;
+
+		for (byte = 0; byte < 4; byte++) {
+			hash ^= (cell >> (byte * 8)) & 0xFF;
+			hash *= 0x100000001B3ULL;
+		}
+	}
+	return hash;
+}
+
 void edit_buffer_release(struct edit_buffer *buf)
 {
 	if (buf->buffer)
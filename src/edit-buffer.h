@@ -19,6 +19,8 @@
 #ifndef _EDIT_BUFFER_H
 #define _EDIT_BUFFER_H 1
 
+#include <stdbool.h>
+
 struct screen;
 
 #define CHAR_ATTR_TO_INT(attr, c) (((attr & 0xFF) << 8) | (c & 0xFF))
@@ -30,14 +32,22 @@ struct edit_buffer {
 	unsigned long height;
 	unsigned long width;
 	unsigned long max_height;
+	unsigned long dirty_from;	/* first row changed since the last
+					   save, height if none */
+	unsigned long changed_from;	/* rows changed since the last */
+	unsigned long changed_to;	/* edit_buffer_take_changes() */
 	unsigned int *buffer;
 };
 
 struct edit_buffer * edit_buffer_create(unsigned long, unsigned long);
+struct edit_buffer * edit_buffer_clone(struct edit_buffer *);
+unsigned long long edit_buffer_hash(struct edit_buffer *);
 void edit_buffer_release(struct edit_buffer *);
 void edit_buffer_clear(struct edit_buffer *);
 void edit_buffer_draw_to_screen(struct edit_buffer *, struct screen *);
 void edit_buffer_put(struct edit_buffer *, unsigned long, unsigned long, int);
 int edit_buffer_get(struct edit_buffer *, unsigned long, unsigned long);
+bool edit_buffer_take_changes(struct edit_buffer *, unsigned long *,
+			      unsigned long *);
 
 #endif
@@ -19,9 +19,28 @@
 #ifndef _EDITOR_CONTEXT_H
 #define _EDITOR_CONTEXT_H 1
 
+#include <stdbool.h>
+
+enum search_result {
+	SEARCH_NONE,
+	SEARCH_NOT_FOUND,
+	SEARCH_BAD_PATTERN
+};
+
 struct editor_context {
 	int fg_color;
 	int bg_color;
+	char * filename;
+	bool modified;
+	unsigned long generation;	/* bumped on every change */
+	bool show_stats;
+	bool show_minimap;
+	bool picking_row;		/* in the minimap, to jump to */
+	unsigned long picked_row;	/* minimap row */
+	bool recording_macro;
+	enum search_result search_result;	/* of the last find */
+	int save_progress;		/* percent, -1 when not saving */
+	bool save_failed;
 };
 
 #endif
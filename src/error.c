@@ -4,11 +4,12 @@
  * Distributed under the terms of the GNU General Public License
  * version 2 or later.
  */
-#include <curses.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "screen.h"
+
 #define ERROR_MSG_BUFFER 1024
 
 void
@@ -17,7 +18,7 @@ error(const char *format, ...)
 	va_list args;
 	char buffer[ERROR_MSG_BUFFER];
 
-	endwin();
+	screen_restore_terminal();
 	va_start(args, format);
 	vsnprintf(buffer, ERROR_MSG_BUFFER, format, args);
 	va_end(args);
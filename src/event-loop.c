@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "error.h"
+#include "event-loop.h"
+
+/*
+ *	Event loop
+ *
+ *	The editor sleeps in poll() until there is input, the terminal is
+ *	resized, a timer expires or a background job completes.  Signals
+ *	and completions write a byte to a self-pipe so that one poll()
+ *	covers all of them.
+ */
+
+static int self_pipe[2] = { -1, -1 };
+
+static unsigned long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+static void wake_up(void)
+{
+	char byte = 0;
+
+	if (write(self_pipe[1], &byte, 1) < 0)
+		; /* Pipe full is fine, the loop has bytes to read.  */
+}
+
+/*
+ *	File descriptors
+ */
+
+#define MAX_WATCHES 8
+
+struct fd_watch {
+	int fd;
+	void (*fn)(int, short, void *);
+	void * data;
+};
+
+static struct fd_watch watches[MAX_WATCHES];
+static unsigned long nr_watches;
+
+void event_loop_watch_fd(int fd, void (*fn)(int, short, void *), void * data)
+{
+	if (nr_watches == MAX_WATCHES)
+		error("Too many file descriptors to watch.");
+
+	watches[nr_watches].fd = fd;
+	watches[nr_watches].fn = fn;
+	watches[nr_watches].data = data;
+	nr_watches++;
+}
+
+void event_loop_unwatch_fd(int fd)
+{
+	unsigned long i;
+
+	for (i = 0; i < nr_watches; i++) {
+		if (watches[i].fd == fd) {
+			watches[i] = watches[--nr_watches];
+			return;
+		}
+	}
+}
+
+static void dispatch_fd(int fd, short revents)
+{
+	unsigned long i;
+
+	/* Look the watch up again; an earlier callback may have
+	   removed it.  */
+	for (i = 0; i < nr_watches; i++) {
+		if (watches[i].fd == fd) {
+			watches[i].fn(fd, revents, watches[i].data);
+			return;
+		}
+	}
+}
+
+/*
+ *	Terminal resize
+ */
+
+static volatile sig_atomic_t resized = 0;
+
+static void (*resize_fn)(void *);
+static void * resize_data;
+
+static void sigwinch_handler(int sig)
+{
+	int saved_errno = errno;
+
+	resized = 1;
+	wake_up();
+	errno = saved_errno;
+}
+
+void event_loop_on_resize(void (*fn)(void *), void * data)
+{
+	resize_fn = fn;
+	resize_data = data;
+}
+
+/*
+ *	Timer wheel
+ *
+ *	Timers hash into a slot by their expiry tick.  Each tick the loop
+ *	visits one slot and fires the timers in it that are due; timers
+ *	further than one revolution away stay for a later round.
+ */
+
+#define WHEEL_SIZE 256
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+
+static struct event_timer * wheel[WHEEL_SIZE];
+static unsigned long wheel_tick;	/* last tick that has been run */
+static unsigned long nr_timers;
+
+static unsigned long current_tick(void)
+{
+	return now_ns() / (EVENT_LOOP_TICK_MS * 1000000UL);
+}
+
+static unsigned long ms_to_ticks(unsigned long ms)
+{
+	unsigned long ticks = ms / EVENT_LOOP_TICK_MS;
+
+	return ticks > 0 ? ticks : 1;
+}
+
+static void wheel_insert(struct event_timer * timer)
+{
+	struct event_timer ** slot = &wheel[timer->expires & WHEEL_MASK];
+
+	timer->next = *slot;
+	*slot = timer;
+	timer->pending = true;
+	nr_timers++;
+}
+
+void event_loop_add_timer(struct event_timer * timer, unsigned long delay_ms,
+			  unsigned long interval_ms)
+{
+	if (timer->pending)
+		event_loop_del_timer(timer);
+
+	timer->expires = current_tick() + ms_to_ticks(delay_ms);
+	timer->interval = interval_ms ? ms_to_ticks(interval_ms) : 0;
+	wheel_insert(timer);
+}
+
+void event_loop_del_timer(struct event_timer * timer)
+{
+	struct event_timer ** p;
+
+	if (!timer->pending)
+		return;
+
+	for (p = &wheel[timer->expires & WHEEL_MASK]; *p; p = &(*p)->next) {
+		if (*p == timer) {
+			*p = timer->next;
+			timer->pending = false;
+			nr_timers--;
+			return;
+		}
+	}
+}
+
+/* Fire due timers one at a time since callbacks may change the slot.  */
+static void run_slot(unsigned long tick, unsigned long now)
+{
+	struct event_timer ** slot = &wheel[tick & WHEEL_MASK];
+
+	for (;;) {
+		struct event_timer * timer;
+
+		for (timer = *slot; timer; timer = timer->next) {
+			if (timer->expires <= now)
+				break;
+		}
+		if (!timer)
+			return;
+
+		event_loop_del_timer(timer);
+		if (timer->interval) {
+			timer->expires = now + timer->interval;
+			wheel_insert(timer);
+		}
+		timer->fn(timer);
+	}
+}
+
+static void run_timers(void)
+{
+	unsigned long now = current_tick();
+	unsigned long tick = wheel_tick + 1;
+
+	/* After a long sleep every slot is due; visit each just once.  */
+	if (now - wheel_tick > WHEEL_SIZE)
+		tick = now - WHEEL_SIZE + 1;
+
+	for (; nr_timers > 0 && tick <= now; tick++)
+		run_slot(tick, now);
+
+	wheel_tick = now;
+}
+
+/*
+ *	Milliseconds until the next timer is due or -1 if there are none.
+ *	The slots are walked forward from the last tick run and the walk
+ *	stops at the first one holding a timer due in this revolution.  If
+ *	none is, the loop wakes after a revolution and looks again.
+ */
+static int timers_timeout(void)
+{
+	unsigned long earliest = wheel_tick + WHEEL_SIZE;
+	unsigned long tick;
+
+	if (nr_timers == 0)
+		return -1;
+
+	for (tick = wheel_tick + 1; tick <= earliest; tick++) {
+		struct event_timer * timer;
+
+		for (timer = wheel[tick & WHEEL_MASK]; timer;
+		     timer = timer->next) {
+			if (timer->expires <= tick && timer->expires < earliest)
+				earliest = timer->expires;
+		}
+	}
+
+	unsigned long now = now_ns() / 1000000UL;
+	unsigned long due = earliest * EVENT_LOOP_TICK_MS;
+
+	if (due <= now)
+		return 0;
+	if (due - now > INT_MAX)
+		return INT_MAX;
+	return due - now;
+}
+
+/*
+ *	Completion queue
+ *
+ *	Background threads hand results back to the editor through here
+ *	so that everything touching editor state runs on one thread.
+ */
+
+struct completion {
+	void (*fn)(void *);
+	void * data;
+	struct completion * next;
+};
+
+static pthread_mutex_t completions_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct completion * completions;
+static struct completion ** completions_tail = &completions;
+
+void event_loop_complete(void (*fn)(void *), void * data)
+{
+	struct completion * completion = malloc(sizeof(struct completion));
+	if (!completion)
+		error("Could not allocate memory for completion.");
+
+	completion->fn = fn;
+	completion->data = data;
+	completion->next = NULL;
+
+	pthread_mutex_lock(&completions_lock);
+	*completions_tail = completion;
+	completions_tail = &completion->next;
+	pthread_mutex_unlock(&completions_lock);
+
+	wake_up();
+}
+
+static void run_completions(void)
+{
+	pthread_mutex_lock(&completions_lock);
+	struct completion * completion = completions;
+	completions = NULL;
+	completions_tail = &completions;
+	pthread_mutex_unlock(&completions_lock);
+
+	while (completion) {
+		struct completion * next = completion->next;
+
+		completion->fn(completion->data);
+		free(completion);
+		completion = next;
+	}
+}
+
+/*
+ *	Idle work
+ *
+ *	Queued work runs round-robin in slices until the budget is spent,
+ *	then the loop checks for events again before the next round.
+ */
+
+#define IDLE_BUDGET_NS 2000000UL
+
+static struct event_idle * idle_head;
+static struct event_idle ** idle_tail = &idle_head;
+
+void event_loop_add_idle(struct event_idle * idle)
+{
+	if (idle->queued)
+		return;
+
+	idle->next = NULL;
+	idle->queued = true;
+	*idle_tail = idle;
+	idle_tail = &idle->next;
+}
+
+static void run_idle(void)
+{
+	unsigned long deadline = now_ns() + IDLE_BUDGET_NS;
+
+	while (idle_head && now_ns() < deadline) {
+		struct event_idle * idle = idle_head;
+
+		idle_head = idle->next;
+		if (!idle_head)
+			idle_tail = &idle_head;
+		idle->queued = false;
+
+		if (idle->fn(idle))
+			event_loop_add_idle(idle);
+	}
+}
+
+/*
+ *	Main loop
+ */
+
+void event_loop_run_once(void)
+{
+	struct pollfd pfds[MAX_WATCHES + 1];
+	unsigned long i, nr_fds = 0;
+	char bytes[64];
+
+	pfds[nr_fds].fd = self_pipe[0];
+	pfds[nr_fds].events = POLLIN;
+	nr_fds++;
+
+	for (i = 0; i < nr_watches; i++) {
+		pfds[nr_fds].fd = watches[i].fd;
+		pfds[nr_fds].events = POLLIN;
+		nr_fds++;
+	}
+
+	int timeout = idle_head ? 0 : timers_timeout();
+
+	int ret = poll(pfds, nr_fds, timeout);
+	if (ret < 0) {
+		if (errno != EINTR)
+			error("Could not wait for events.");
+		ret = 0;
+	}
+
+	if (pfds[0].revents) {
+		while (read(self_pipe[0], bytes, sizeof(bytes)) > 0)
+			;
+	}
+
+	if (resized) {
+		resized = 0;
+		if (resize_fn)
+			resize_fn(resize_data);
+	}
+
+	run_completions();
+
+	for (i = 1; i < nr_fds; i++) {
+		if (pfds[i].revents)
+			dispatch_fd(pfds[i].fd, pfds[i].revents);
+	}
+
+	run_timers();
+
+	if (ret == 0)
+		run_idle();
+}
+
+void event_loop_init(void)
+{
+	if (pipe(self_pipe) < 0)
+		error("Could not create event pipe.");
+
+	fcntl(self_pipe[0], F_SETFL, O_NONBLOCK);
+	fcntl(self_pipe[1], F_SETFL, O_NONBLOCK);
+
+	wheel_tick = current_tick();
+
+	/* Installed before the screen is set up so that curses leaves
+	   SIGWINCH to us.  */
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sigwinch_handler;
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGWINCH, &sa, NULL);
+}
+
+void event_loop_release(void)
+{
+	signal(SIGWINCH, SIG_DFL);
+
+	run_completions();
+
+	close(self_pipe[0]);
+	close(self_pipe[1]);
+	self_pipe[0] = self_pipe[1] = -1;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _EVENT_LOOP_H
+#define _EVENT_LOOP_H 1
+
+#include <stdbool.h>
+
+/*
+ *	Timers are kept on a hashed timing wheel with a resolution of
+ *	EVENT_LOOP_TICK_MS.  A timer with a non-zero interval is re-armed
+ *	every time it fires.
+ */
+#define EVENT_LOOP_TICK_MS 10
+
+struct event_timer {
+	unsigned long expires;		/* in ticks */
+	unsigned long interval;		/* in ticks */
+	void (*fn)(struct event_timer *);
+	void * data;
+	struct event_timer * next;
+	bool pending;
+};
+
+/*
+ *	Idle work is run in slices whenever there are no events to handle.
+ *	The function does a small bounded amount of work and returns true
+ *	as long as there is more to do.
+ */
+struct event_idle {
+	bool (*fn)(struct event_idle *);
+	void * data;
+	struct event_idle * next;
+	bool queued;
+};
+
+void event_loop_init(void);
+void event_loop_release(void);
+
+/* Call fn when fd is readable or hung up.  */
+void event_loop_watch_fd(int, void (*)(int, short, void *), void *);
+void event_loop_unwatch_fd(int);
+
+void event_loop_on_resize(void (*)(void *), void *);
+
+void event_loop_add_timer(struct event_timer *, unsigned long,
+			  unsigned long);
+void event_loop_del_timer(struct event_timer *);
+
+void event_loop_add_idle(struct event_idle *);
+
+/* Run fn on the event loop thread.  Safe to call from any thread.  */
+void event_loop_complete(void (*)(void *), void *);
+
+/* Wait for something to happen and dispatch it.  */
+void event_loop_run_once(void);
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _FONT_H
+#define _FONT_H 1
+
+/*
+ *	Bitmap fonts for the CP437 character set, 8 pixels wide.  Each
+ *	glyph is height bytes, one per pixel row from the top, with the
+ *	leftmost pixel in the high bit.
+ */
+struct font {
+	const char * name;
+	unsigned int height;
+	const unsigned char * glyphs;	/* 256 * height bytes */
+};
+
+extern const struct font font_8x16;
+extern const struct font font_8x8;
+
+const struct font * font_lookup(const char *);
+
+#endif
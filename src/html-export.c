@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "cp437.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "html-export.h"
+
+/*
+ *	HTML export
+ *
+ *	The canvas becomes a <pre> block with a <span> for every run of
+ *	cells with the same attributes, colored by class from a style
+ *	sheet in the page.  Cells in the default colors need no span, and
+ *	a blank cell joins the run before it if the background matches,
+ *	since its foreground doesn't show.  Runs carry on across lines.
+ */
+
+#define DEFAULT_ATTR 0x07		/* light gray on black */
+
+#define HTML_BUFFER_SIZE 65536
+
+static const char * css_colors[16] = {
+	"#000", "#a00", "#0a0", "#a50", "#00a", "#a0a", "#0aa", "#aaa",
+	"#555", "#f55", "#5f5", "#ff5", "#55f", "#f5f", "#5ff", "#fff"
+};
+
+/* Cells and span tags as they are written out, escaped for HTML.  */
+struct html_string {
+	char bytes[24];
+	unsigned int len;
+};
+
+static struct html_string html_glyphs[256];
+static struct html_string html_spans[256];
+static bool tables_built = false;
+
+static void set_string(struct html_string * str, const char * text)
+{
+	str->len = strlen(text);
+	memcpy(str->bytes, text, str->len);
+}
+
+static void build_tables(void)
+{
+	const struct cp437_glyph * utf8 = cp437_utf8_glyphs();
+	char text[24];
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		unsigned int u = cp437_to_unicode[i];
+
+		if (u == '<')
+			set_string(&html_glyphs[i], "&lt;");
+		else if (u == '>')
+			set_string(&html_glyphs[i], "&gt;");
+		else if (u == '&')
+			set_string(&html_glyphs[i], "&amp;");
+		else {
+			memcpy(html_glyphs[i].bytes, utf8[i].bytes,
+			       utf8[i].len);
+			html_glyphs[i].len = utf8[i].len;
+		}
+
+		if ((i & 0x0f) != (DEFAULT_ATTR & 0x0f) && (i >> 4) != 0)
+			sprintf(text, "<span class=\"f%d b%d\">", i & 0x0f,
+				i >> 4);
+		else if ((i >> 4) != 0)
+			sprintf(text, "<span class=\"b%d\">", i >> 4);
+		else
+			sprintf(text, "<span class=\"f%d\">", i & 0x0f);
+		set_string(&html_spans[i], text);
+	}
+	tables_built = true;
+}
+
+/*
+ *	Output goes through one large buffer rather than stdio a few
+ *	bytes at a time.
+ */
+
+struct html_output {
+	FILE * file;
+	unsigned long len;
+	bool ok;
+	char buf[HTML_BUFFER_SIZE];
+};
+
+static void html_flush(struct html_output * out)
+{
+	if (out->len && fwrite(out->buf, out->len, 1, out->file) != 1)
+		out->ok = false;
+	out->len = 0;
+}
+
+static inline void html_put(struct html_output * out, const char * bytes,
+			    unsigned long len)
+{
+	if (out->len + len > HTML_BUFFER_SIZE) {
+		html_flush(out);
+		if (len > HTML_BUFFER_SIZE) {
+			if (fwrite(bytes, len, 1, out->file) != 1)
+				out->ok = false;
+			return;
+		}
+	}
+	memcpy(out->buf + out->len, bytes, len);
+	out->len += len;
+}
+
+static void html_puts(struct html_output * out, const char * text)
+{
+	html_put(out, text, strlen(text));
+}
+
+/* Page titles are file names, which need escaping too.  */
+static void html_put_title(struct html_output * out, const char * title)
+{
+	for (; *title; title++) {
+		if (*title == '<')
+			html_puts(out, "&lt;");
+		else if (*title == '>')
+			html_puts(out, "&gt;");
+		else if (*title == '&')
+			html_puts(out, "&amp;");
+		else
+			html_put(out, title, 1);
+	}
+}
+
+static void html_put_header(struct html_output * out, const char * title)
+{
+	char rule[64];
+	int i;
+
+	html_puts(out, "<!DOCTYPE html>\n<html>\n<head>\n"
+		  "<meta charset=\"utf-8\">\n<title>");
+	html_put_title(out, title ? title : "newdraw");
+	html_puts(out, "</title>\n<style>\n"
+		  "pre.ansi { background: #000; color: #aaa; "
+		  "font-family: monospace; line-height: 1; }\n");
+	for (i = 0; i < 16; i++) {
+		sprintf(rule, ".f%d { color: %s; }\n", i, css_colors[i]);
+		html_puts(out, rule);
+	}
+	for (i = 0; i < 16; i++) {
+		sprintf(rule, ".b%d { background: %s; }\n", i, css_colors[i]);
+		html_puts(out, rule);
+	}
+	html_puts(out, "</style>\n</head>\n<body>\n<pre class=\"ansi\">");
+}
+
+static bool is_blank(unsigned int cell)
+{
+	return (cell & 0xff) == ' ' || (cell & 0xff) == 0
+		|| (cell & 0xff) == 0xff;
+}
+
+/* Trailing blanks on black are left out.  */
+static unsigned long row_length(struct edit_buffer * buf, unsigned long y)
+{
+	const unsigned int * row = &buf->buffer[y * buf->width];
+	unsigned long len = buf->width;
+
+	while (len > 0 && is_blank(row[len - 1])
+	       && (row[len - 1] & 0xf000) == 0)
+		len--;
+	return len;
+}
+
+bool html_export(FILE * file, struct edit_buffer * buf, const char * title)
+{
+	struct html_output * out = malloc(sizeof(struct html_output));
+	unsigned int cur = DEFAULT_ATTR;
+	unsigned long x, y;
+	bool ok;
+
+	if (!out)
+		error("Could not allocate memory for HTML export.");
+
+	if (!tables_built)
+		build_tables();
+
+	out->file = file;
+	out->len = 0;
+	out->ok = true;
+
+	html_put_header(out, title);
+
+	for (y = 0; y < buf->max_height; y++) {
+		const unsigned int * row = &buf->buffer[y * buf->width];
+		unsigned long len = row_length(buf, y);
+
+		for (x = 0; x < len; x++) {
+			unsigned int attr = (row[x] >> 8) & 0xff;
+
+			if (attr != cur && !(is_blank(row[x])
+					     && (attr & 0xf0) == (cur & 0xf0))) {
+				if (cur != DEFAULT_ATTR)
+					html_put(out, "</span>", 7);
+				if (attr != DEFAULT_ATTR)
+					html_put(out, html_spans[attr].bytes,
+						 html_spans[attr].len);
+				cur = attr;
+			}
+			html_put(out, html_glyphs[row[x] & 0xff].bytes,
+				 html_glyphs[row[x] & 0xff].len);
+		}
+		html_put(out, "\n", 1);
+	}
+	if (cur != DEFAULT_ATTR)
+		html_puts(out, "</span>");
+
+	html_puts(out, "</pre>\n</body>\n</html>\n");
+	html_flush(out);
+
+	ok = out->ok;
+	free(out);
+	return ok && fflush(file) == 0 && !ferror(file);
+}
+
+/* Files saved under these names are written as HTML.  */
+bool html_check(const char * filename)
+{
+	const char * ext = strrchr(filename, '.');
+
+	return ext && (strcasecmp(ext, ".html") == 0
+		       || strcasecmp(ext, ".htm") == 0);
+}
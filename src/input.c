@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "error.h"
+#include "input.h"
+#include "screen.h"
+
+/*
+ *	Keyboard input
+ *
+ *	Keys can be read and decoded on a dedicated thread so that a slow
+ *	frame never delays reading the next key.  The input thread
+ *	produces events into a lock-free single-producer/single-consumer
+ *	ring and the editor consumes them in batches.  A byte written to
+ *	a pipe for every event wakes the consumer up.
+ */
+
+unsigned long input_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+#define META_KEY_CODE 0x1B
+
+/* META seen without the key that follows it yet.  */
+static bool meta_pending = false;
+
+static int decode_key(void)
+{
+	int ch;
+
+	if (meta_pending) {
+		meta_pending = false;
+		ch = META_KEY_CODE;
+	} else
+		ch = screen_get_key();
+
+	if (ch == META_KEY_CODE) {
+		/* After META comes the actual key we're interested in.  */
+		ch = KEY_META(screen_get_key());
+	}
+	return ch;
+}
+
+/*
+ *	Event ring
+ */
+
+#define CACHE_LINE 64
+
+static struct input_event ring[INPUT_RING_SIZE];
+
+/* Producer and consumer indexes on separate cache lines.  */
+static _Alignas(CACHE_LINE) atomic_ulong ring_head;
+static _Alignas(CACHE_LINE) atomic_ulong ring_tail;
+
+static int wakeup_pipe[2] = { -1, -1 };
+
+static bool use_ring = false;
+static bool thread_started = false;
+static pthread_t input_thread;
+
+void input_push(int key)
+{
+	unsigned long head = atomic_load_explicit(&ring_head,
+						  memory_order_relaxed);
+
+	/* Full ring means the editor is hopelessly behind; wait.  */
+	while (head - atomic_load_explicit(&ring_tail, memory_order_acquire)
+	       >= INPUT_RING_SIZE)
+		usleep(1000);
+
+	struct input_event * event = &ring[head & (INPUT_RING_SIZE - 1)];
+	event->key = key;
+	event->timestamp = input_now();
+
+	atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+
+	char byte = 0;
+	if (write(wakeup_pipe[1], &byte, 1) < 0)
+		; /* Pipe full is fine, the consumer has bytes to read.  */
+}
+
+static unsigned long ring_pop(struct input_event * events, unsigned long max)
+{
+	unsigned long tail = atomic_load_explicit(&ring_tail,
+						  memory_order_relaxed);
+	unsigned long head = atomic_load_explicit(&ring_head,
+						  memory_order_acquire);
+	unsigned long nr = 0;
+
+	while (tail != head && nr < max)
+		events[nr++] = ring[tail++ & (INPUT_RING_SIZE - 1)];
+
+	atomic_store_explicit(&ring_tail, tail, memory_order_release);
+
+	return nr;
+}
+
+static void drain_wakeup(void)
+{
+	char bytes[64];
+
+	while (read(wakeup_pipe[0], bytes, sizeof(bytes)) > 0)
+		;
+}
+
+static void wait_wakeup(void)
+{
+	struct pollfd pfd = { .fd = wakeup_pipe[0], .events = POLLIN };
+
+	while (poll(&pfd, 1, -1) < 0 && errno == EINTR)
+		;
+
+	drain_wakeup();
+}
+
+/*
+ *	Consumer side batch.  Events are taken off the ring a batch at a
+ *	time; prompts reading keys in the middle of a batch get the rest
+ *	of it first.
+ */
+#define INPUT_BATCH_SIZE 64
+
+static struct input_event batch[INPUT_BATCH_SIZE];
+static unsigned long batch_len;
+static unsigned long batch_pos;
+
+/* Keys replayed instead of read from the terminal.  */
+static const int * script;
+static unsigned long script_len;
+static unsigned long script_pos;
+
+void input_set_script(const int * keys, unsigned long len)
+{
+	script = keys;
+	script_len = len;
+	script_pos = 0;
+}
+
+/* Block until there is at least one event.  Without the ring a single
+   key is decoded right here.  */
+void input_wait(void)
+{
+	if (batch_pos < batch_len)
+		return;
+
+	batch_pos = 0;
+
+	if (script) {
+		batch[0].key = script_pos < script_len
+			? script[script_pos++] : ERR;
+		batch[0].timestamp = input_now();
+		batch_len = 1;
+		return;
+	}
+
+	if (!use_ring) {
+		batch[0].key = decode_key();
+		batch[0].timestamp = input_now();
+		batch_len = 1;
+		return;
+	}
+
+	while ((batch_len = ring_pop(batch, INPUT_BATCH_SIZE)) == 0)
+		wait_wakeup();
+}
+
+/* Decode the keys that are available without blocking.  */
+static unsigned long decode_available(void)
+{
+	unsigned long nr = 0;
+
+	screen_nodelay(true);
+	while (nr < INPUT_BATCH_SIZE) {
+		int ch = screen_get_key();
+		if (ch == ERR)
+			break;
+
+		if (meta_pending) {
+			meta_pending = false;
+			ch = KEY_META(ch);
+		} else if (ch == META_KEY_CODE) {
+			meta_pending = true;
+			continue;
+		}
+		batch[nr].key = ch;
+		batch[nr].timestamp = input_now();
+		nr++;
+	}
+	screen_nodelay(false);
+
+	return nr;
+}
+
+/*
+ *	Like input_wait() but never blocks; for use from the event loop
+ *	once input_fd() is readable.  Returns false when there is nothing
+ *	to read.
+ */
+bool input_poll(void)
+{
+	if (batch_pos < batch_len)
+		return true;
+
+	batch_pos = 0;
+
+	if (use_ring) {
+		drain_wakeup();
+		batch_len = ring_pop(batch, INPUT_BATCH_SIZE);
+	} else
+		batch_len = decode_available();
+
+	return batch_len > 0;
+}
+
+/* Readable when input_poll() may have something.  */
+int input_fd(void)
+{
+	return use_ring ? wakeup_pipe[0] : STDIN_FILENO;
+}
+
+/* Sees every event handed out, e.g. for recording the session.  */
+static void (*tap)(const struct input_event *);
+
+void input_set_tap(void (*fn)(const struct input_event *))
+{
+	tap = fn;
+}
+
+bool input_next_event(struct input_event * event)
+{
+	if (batch_pos == batch_len)
+		return false;
+
+	*event = batch[batch_pos++];
+	if (tap)
+		tap(event);
+	return true;
+}
+
+int input_get_key(void)
+{
+	struct input_event event = { .key = ERR };
+
+	input_wait();
+	input_next_event(&event);
+	return event.key;
+}
+
+static void * input_thread_fn(void * arg)
+{
+	for (;;) {
+		int key = decode_key();
+
+		input_push(key);
+		if (key == ERR)
+			break;
+	}
+	return NULL;
+}
+
+/* Switch to reading events from the ring, fed with input_push().  */
+void input_init(void)
+{
+	if (pipe(wakeup_pipe) < 0)
+		error("Could not create input pipe.");
+
+	fcntl(wakeup_pipe[0], F_SETFL, O_NONBLOCK);
+	fcntl(wakeup_pipe[1], F_SETFL, O_NONBLOCK);
+
+	use_ring = true;
+}
+
+/*
+ *	Start decoding keys on a thread of their own if the screen
+ *	backend allows reading input concurrently with drawing.
+ */
+void input_start(void)
+{
+	if (!screen_threaded_input())
+		return;
+
+	input_init();
+
+	if (pthread_create(&input_thread, NULL, input_thread_fn, NULL) != 0)
+		error("Could not create input thread.");
+	thread_started = true;
+}
+
+void input_stop(void)
+{
+	if (thread_started) {
+		pthread_cancel(input_thread);
+		pthread_join(input_thread, NULL);
+		thread_started = false;
+	}
+
+	if (use_ring) {
+		close(wakeup_pipe[0]);
+		close(wakeup_pipe[1]);
+		use_ring = false;
+	}
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _INPUT_H
+#define _INPUT_H 1
+
+#include <stdbool.h>
+
+#define INPUT_RING_SIZE 256	/* must be a power of two */
+
+/* Curses-like KEY_xxx macro for combining META key with an character.  */
+#define KEY_META(ch) (0x1000 | ch)
+
+/* Decoded key with the time it was read (monotonic nanoseconds).  */
+struct input_event {
+	int key;
+	unsigned long timestamp;
+};
+
+unsigned long input_now(void);
+
+void input_init(void);
+void input_start(void);
+void input_stop(void);
+void input_push(int);
+void input_wait(void);
+bool input_poll(void);
+int input_fd(void);
+bool input_next_event(struct input_event *);
+int input_get_key(void);
+void input_set_script(const int *, unsigned long);
+void input_set_tap(void (*)(const struct input_event *));
+
+#endif
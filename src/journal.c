@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bytes.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "journal.h"
+
+/*
+ *	Journal format
+ *
+ *	"NDJL", a version byte, then the canvas size and the hash of the
+ *	canvas the journal starts from as varints.  Records follow: a type
+ *	byte, the payload length as a varint, the payload and a 32-bit
+ *	FNV-1a checksum of the payload.  A changes record holds the number
+ *	of changes followed by x, y and cell for each.  A snapshot record
+ *	holds the number of rows in use followed by runs of cells as
+ *	length and cell.  Reading stops at the first record that is cut
+ *	short or does not match its checksum.
+ */
+
+#define JOURNAL_MAGIC "NDJL"
+#define JOURNAL_MAGIC_LEN 4
+#define JOURNAL_VERSION 1
+
+/* Rewrite the journal as a snapshot once it grows past this.  */
+#define JOURNAL_COMPACT_SIZE (256 * 1024)
+
+enum journal_record_type {
+	JOURNAL_SNAPSHOT = 1,
+	JOURNAL_CHANGES = 2
+};
+
+static void put_record(struct bytes * b, enum journal_record_type type,
+		       struct bytes * payload)
+{
+	unsigned int sum = bytes_checksum(payload->data, payload->len);
+	unsigned char sum_bytes[4] = {
+		sum, sum >> 8, sum >> 16, sum >> 24
+	};
+
+	bytes_reserve(b, 1);
+	b->data[b->len++] = type;
+	bytes_put_varint(b, payload->len);
+	bytes_put(b, payload->data, payload->len);
+	bytes_put(b, sum_bytes, 4);
+}
+
+static bool write_all(int fd, const unsigned char * data, unsigned long len)
+{
+	while (len > 0) {
+		ssize_t ret = write(fd, data, len);
+
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data += ret;
+		len -= ret;
+	}
+	return true;
+}
+
+static void encode_snapshot(struct bytes * payload, struct edit_buffer * buf)
+{
+	unsigned long nr_cells = buf->max_height * buf->width;
+	unsigned long i, run;
+
+	bytes_put_varint(payload, buf->max_height);
+	for (i = 0; i < nr_cells; i += run) {
+		unsigned int cell = buf->buffer[i];
+
+		for (run = 1; i + run < nr_cells; run++) {
+			if (buf->buffer[i + run] != cell)
+				break;
+		}
+		bytes_put_varint(payload, run);
+		bytes_put_varint(payload, cell);
+	}
+}
+
+/*
+ *	Writing
+ */
+
+static int journal_fd = -1;
+static char * journal_path;
+static struct edit_buffer * journal_buf;
+static unsigned long journal_size;
+static bool unsynced;
+
+static struct bytes changes;
+static unsigned long nr_changes;
+
+static struct bytes payload;
+static struct bytes out;
+
+/*
+ *	Start a journal at path for buf, replacing the one in use.  With a
+ *	snapshot the journal carries the whole canvas, otherwise it holds
+ *	changes against the canvas as it is now.  The new journal is built
+ *	next to the old one and renamed over it, so a failure leaves the
+ *	old journal in place.
+ */
+bool journal_start(const char * path, struct edit_buffer * buf,
+		   bool snapshot)
+{
+	char * tmp = malloc(strlen(path) + sizeof(".XXXXXX"));
+	int fd;
+
+	if (!tmp)
+		error("Could not allocate memory for journal.");
+	sprintf(tmp, "%s.XXXXXX", path);
+
+	fd = mkstemp(tmp);
+	if (fd < 0) {
+		free(tmp);
+		return false;
+	}
+
+	out.len = 0;
+	bytes_put(&out, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN);
+	bytes_put_varint(&out, JOURNAL_VERSION);
+	bytes_put_varint(&out, buf->width);
+	bytes_put_varint(&out, buf->height);
+	bytes_put_varint(&out, snapshot ? 0 : edit_buffer_hash(buf));
+
+	if (snapshot) {
+		payload.len = 0;
+		encode_snapshot(&payload, buf);
+		put_record(&out, JOURNAL_SNAPSHOT, &payload);
+	}
+
+	if (!write_all(fd, out.data, out.len) || fdatasync(fd) != 0
+	    || rename(tmp, path) != 0) {
+		close(fd);
+		unlink(tmp);
+		free(tmp);
+		return false;
+	}
+	free(tmp);
+
+	if (journal_path && strcmp(journal_path, path) != 0)
+		unlink(journal_path);
+	if (journal_fd >= 0)
+		close(journal_fd);
+	free(journal_path);
+
+	journal_path = strdup(path);
+	if (!journal_path)
+		error("Could not allocate memory for journal.");
+	journal_fd = fd;
+	journal_buf = buf;
+	journal_size = out.len;
+	unsynced = false;
+
+	/* Anything pending is already part of the canvas.  */
+	changes.len = 0;
+	nr_changes = 0;
+	return true;
+}
+
+void journal_put(unsigned long x, unsigned long y, unsigned int cell)
+{
+	if (journal_fd < 0)
+		return;
+
+	bytes_put_varint(&changes, x);
+	bytes_put_varint(&changes, y);
+	bytes_put_varint(&changes, cell);
+	nr_changes++;
+}
+
+/* Append the changes made since the last flush.  */
+void journal_flush(void)
+{
+	if (journal_fd < 0 || nr_changes == 0)
+		return;
+
+	if (journal_size > JOURNAL_COMPACT_SIZE) {
+		char * path = strdup(journal_path);
+		bool compacted = path && journal_start(path, journal_buf, true);
+
+		free(path);
+		if (compacted)
+			return;
+	}
+
+	payload.len = 0;
+	bytes_put_varint(&payload, nr_changes);
+	bytes_put(&payload, changes.data, changes.len);
+
+	out.len = 0;
+	put_record(&out, JOURNAL_CHANGES, &payload);
+
+	changes.len = 0;
+	nr_changes = 0;
+
+	/* Give up on the journal rather than leave a gap in it.  */
+	if (!write_all(journal_fd, out.data, out.len)) {
+		close(journal_fd);
+		journal_fd = -1;
+		return;
+	}
+	journal_size += out.len;
+	unsynced = true;
+}
+
+void journal_sync(void)
+{
+	if (journal_fd >= 0 && unsynced) {
+		fdatasync(journal_fd);
+		unsynced = false;
+	}
+}
+
+/* Drop the journal, once its changes are safe or no longer wanted.  */
+void journal_close(void)
+{
+	if (journal_fd >= 0)
+		close(journal_fd);
+	journal_fd = -1;
+
+	if (journal_path)
+		unlink(journal_path);
+	free(journal_path);
+	journal_path = NULL;
+	journal_buf = NULL;
+
+	changes.len = 0;
+	nr_changes = 0;
+}
+
+/*
+ *	Recovery
+ */
+
+static bool get_record(struct byte_reader * r, int * type, struct byte_reader * rec)
+{
+	unsigned long long len;
+	const unsigned char * sum;
+
+	if (r->pos == r->len)
+		return false;
+
+	*type = r->data[r->pos++];
+	if (!bytes_get_varint(r, &len) || len > r->len - r->pos
+	    || r->len - r->pos - len < 4)
+		return false;
+
+	rec->data = r->data + r->pos;
+	rec->len = len;
+	rec->pos = 0;
+	r->pos += len;
+
+	sum = r->data + r->pos;
+	r->pos += 4;
+
+	return bytes_checksum(rec->data, len) == (sum[0] | sum[1] << 8
+					    | sum[2] << 16
+					    | (unsigned int) sum[3] << 24);
+}
+
+static bool apply_snapshot(struct byte_reader * r, struct edit_buffer * buf)
+{
+	unsigned long long rows, run, cell;
+	unsigned long i = 0, nr_cells;
+
+	if (!bytes_get_varint(r, &rows) || rows > buf->height)
+		return false;
+
+	edit_buffer_clear(buf);
+
+	nr_cells = rows * buf->width;
+	while (i < nr_cells) {
+		if (!bytes_get_varint(r, &run) || !bytes_get_varint(r, &cell)
+		    || run > nr_cells - i)
+			return false;
+
+		for (; run > 0; run--, i++)
+			edit_buffer_put(buf, i % buf->width, i / buf->width,
+					cell);
+	}
+	return true;
+}
+
+static bool apply_changes(struct byte_reader * r, struct edit_buffer * buf)
+{
+	unsigned long long nr, x, y, cell;
+
+	if (!bytes_get_varint(r, &nr))
+		return false;
+
+	while (nr-- > 0) {
+		if (!bytes_get_varint(r, &x) || !bytes_get_varint(r, &y)
+		    || !bytes_get_varint(r, &cell)
+		    || x >= buf->width || y >= buf->height)
+			return false;
+
+		edit_buffer_put(buf, x, y, cell);
+	}
+	return true;
+}
+
+/* Bring buf up to date with the journal at path.  */
+enum journal_status journal_recover(const char * path,
+				    struct edit_buffer * buf)
+{
+	enum journal_status status = JOURNAL_NONE;
+	unsigned long long version, width, height, hash;
+	struct byte_reader r, rec;
+	bool first = true;
+	int type;
+
+	r.data = bytes_read_file(path, &r.len);
+	r.pos = JOURNAL_MAGIC_LEN;
+	if (!r.data)
+		return JOURNAL_NONE;
+
+	if (r.len < JOURNAL_MAGIC_LEN
+	    || memcmp(r.data, JOURNAL_MAGIC, JOURNAL_MAGIC_LEN) != 0
+	    || !bytes_get_varint(&r, &version) || version != JOURNAL_VERSION
+	    || !bytes_get_varint(&r, &width) || !bytes_get_varint(&r, &height)
+	    || !bytes_get_varint(&r, &hash))
+		goto out;
+
+	if (width != buf->width || height != buf->height) {
+		status = JOURNAL_MISMATCH;
+		goto out;
+	}
+
+	while (get_record(&r, &type, &rec)) {
+		if (first && type != JOURNAL_SNAPSHOT
+		    && hash != edit_buffer_hash(buf)) {
+			status = JOURNAL_MISMATCH;
+			break;
+		}
+		first = false;
+
+		if (type == JOURNAL_SNAPSHOT) {
+			if (!apply_snapshot(&rec, buf))
+				break;
+		} else if (type == JOURNAL_CHANGES) {
+			if (!apply_changes(&rec, buf))
+				break;
+		} else
+			break;
+		status = JOURNAL_RECOVERED;
+	}
+out:
+	free((void *) r.data);
+	return status;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _JOURNAL_H
+#define _JOURNAL_H 1
+
+#include <stdbool.h>
+
+struct edit_buffer;
+
+/*
+ *	The journal is an append-only sidecar file holding the cell
+ *	changes made since the canvas was last saved, so that they survive
+ *	the editor dying.  Changes are collected as they are made and
+ *	written out once per frame.
+ */
+
+enum journal_status {
+	JOURNAL_NONE,			/* no journal or nothing in it */
+	JOURNAL_RECOVERED,
+	JOURNAL_MISMATCH		/* made against a different canvas */
+};
+
+enum journal_status journal_recover(const char *, struct edit_buffer *);
+
+bool journal_start(const char *, struct edit_buffer *, bool);
+void journal_put(unsigned long, unsigned long, unsigned int);
+void journal_flush(void);
+void journal_sync(void);
+void journal_close(void);
+
+#endif
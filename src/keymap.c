@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <ctype.h>
+#include <curses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "input.h"
+#include "keymap.h"
+
+const struct keymap_command * keymap[KEYMAP_SIZE];
+const struct keymap_command * keymap_fallback;
+
+static const struct keymap_command * commands;
+static unsigned long nr_commands;
+
+static void bind(int key, const char * name)
+{
+	const struct keymap_command * cmd = keymap_find_command(name);
+
+	if (!cmd)
+		error("Unknown command '%s'.", name);
+	keymap[key] = cmd;
+}
+
+void keymap_init(const struct keymap_command * cmds, unsigned long nr_cmds,
+		 const struct keymap_command * fallback,
+		 const struct keymap_binding * bindings,
+		 unsigned long nr_bindings)
+{
+	unsigned long i;
+
+	commands = cmds;
+	nr_commands = nr_cmds;
+	keymap_fallback = fallback;
+
+	for (i = 0; i < KEYMAP_SIZE; i++)
+		keymap[i] = fallback;
+
+	for (i = 0; i < nr_bindings; i++)
+		bind(bindings[i].key, bindings[i].command);
+}
+
+const struct keymap_command * keymap_find_command(const char * name)
+{
+	unsigned long i;
+
+	for (i = 0; i < nr_commands; i++) {
+		if (strcmp(commands[i].name, name) == 0)
+			return &commands[i];
+	}
+	return NULL;
+}
+
+/*
+ *	Key names
+ *
+ *	A key is a single character, C-<char> for a control character, one
+ *	of the names below, F1 to F63, or a key code in hex such as 0x1b.
+ *	Any of these can be prefixed with M- for META.
+ */
+
+static const struct {
+	const char * name;
+	int key;
+} key_names[] = {
+	{ "Up",		KEY_UP },
+	{ "Down",	KEY_DOWN },
+	{ "Left",	KEY_LEFT },
+	{ "Right",	KEY_RIGHT },
+	{ "Home",	KEY_HOME },
+	{ "End",	KEY_END },
+	{ "PageUp",	KEY_PPAGE },
+	{ "PageDown",	KEY_NPAGE },
+	{ "Insert",	KEY_IC },
+	{ "Delete",	KEY_DC },
+	{ "Backspace",	KEY_BACKSPACE },
+	{ "Resize",	KEY_RESIZE },
+	{ "Tab",	'\t' },
+	{ "Enter",	'\r' },
+	{ "Esc",	0x1b },
+	{ "Space",	' ' },
+	{ "Hash",	'#' }
+};
+
+#define NR_KEY_NAMES (sizeof(key_names) / sizeof(key_names[0]))
+
+/* Returns -1 if the name is not a key that fits in the keymap.  */
+int keymap_parse_key(const char * name)
+{
+	unsigned long i;
+	char * end;
+	long key = -1;
+	int meta = 0;
+
+	if (strncmp(name, "M-", 2) == 0 && name[2] != 0) {
+		meta = KEY_META(0);
+		name += 2;
+	}
+
+	if (name[0] != 0 && name[1] == 0) {
+		key = (unsigned char) name[0];
+	} else if (strncmp(name, "C-", 2) == 0 && name[2] != 0
+		   && name[3] == 0) {
+		key = toupper((unsigned char) name[2]) & 0x1f;
+	} else if (strncmp(name, "0x", 2) == 0) {
+		key = strtol(name + 2, &end, 16);
+		if (end == name + 2 || *end != 0)
+			return -1;
+	} else if (name[0] == 'F' && isdigit((unsigned char) name[1])) {
+		long n = strtol(name + 1, &end, 10);
+		if (*end != 0 || n < 1 || n > 63)
+			return -1;
+		key = KEY_F(n);
+	} else {
+		for (i = 0; i < NR_KEY_NAMES; i++) {
+			if (strcmp(key_names[i].name, name) == 0) {
+				key = key_names[i].key;
+				break;
+			}
+		}
+	}
+
+	if (key < 0 || (key | meta) >= KEYMAP_SIZE)
+		return -1;
+	return key | meta;
+}
+
+/*
+ *	Keymap files
+ *
+ *	One binding per line, a key followed by the name of a command.
+ *	Blank lines and lines starting with '#' are ignored.
+ */
+
+#define MAX_KEYMAP_LINE 256
+
+/* Returns false if the file could not be opened.  */
+bool keymap_load(const char * path)
+{
+	char line[MAX_KEYMAP_LINE];
+	unsigned long lineno = 0;
+	FILE * file = fopen(path, "r");
+
+	if (!file)
+		return false;
+
+	while (fgets(line, sizeof(line), file)) {
+		const char * delim = " \t\r\n";
+		char * key_name, * cmd_name;
+		const struct keymap_command * cmd;
+		int key;
+
+		lineno++;
+		key_name = strtok(line, delim);
+		if (!key_name || key_name[0] == '#')
+			continue;
+
+		cmd_name = strtok(NULL, delim);
+		if (!cmd_name || strtok(NULL, delim))
+			error("%s:%lu: expected a key and a command.",
+			      path, lineno);
+
+		key = keymap_parse_key(key_name);
+		if (key < 0)
+			error("%s:%lu: unknown key '%s'.",
+			      path, lineno, key_name);
+
+		cmd = keymap_find_command(cmd_name);
+		if (!cmd)
+			error("%s:%lu: unknown command '%s'.",
+			      path, lineno, cmd_name);
+
+		keymap[key] = cmd;
+	}
+	fclose(file);
+	return true;
+}
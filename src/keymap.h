@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _KEYMAP_H
+#define _KEYMAP_H 1
+
+#include <stdbool.h>
+
+struct edit_buffer;
+struct screen;
+struct editor_context;
+
+/*
+ *	Keys are dispatched through a flat table indexed by the decoded
+ *	key code, META keys included.  Keys that are not bound, and codes
+ *	that do not fit in the table, run the fallback command.
+ */
+#define KEYMAP_SIZE 0x2000
+
+struct keymap_command {
+	const char * name;
+	/* Returns false when the editor should quit.  */
+	bool (*fn)(struct edit_buffer *, struct screen *,
+		   struct editor_context *, int);
+	bool recordable;		/* can be part of a macro */
+};
+
+struct keymap_binding {
+	int key;
+	const char * command;
+};
+
+extern const struct keymap_command * keymap[KEYMAP_SIZE];
+extern const struct keymap_command * keymap_fallback;
+
+void keymap_init(const struct keymap_command *, unsigned long,
+		 const struct keymap_command *,
+		 const struct keymap_binding *, unsigned long);
+const struct keymap_command * keymap_find_command(const char *);
+int keymap_parse_key(const char *);
+bool keymap_load(const char *);
+
+static inline const struct keymap_command * keymap_lookup(int key)
+{
+	if ((unsigned int) key < KEYMAP_SIZE)
+		return keymap[key];
+	return keymap_fallback;
+}
+
+#endif
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdlib.h>
+
+#include "colors.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "minimap.h"
+#include "screen.h"
+
+/*
+ *	Minimap
+ *
+ *	Each minimap cell is an upper half block in the color most of the
+ *	upper half of its source cells show, over the color of the lower
+ *	half.  Only the rows of cells under rows changed since the last
+ *	update are worked out again, so keeping the minimap current costs
+ *	a row or two per key however large the canvas is.
+ */
+
+#define BORDER_ATTR	COLOR_ATTR(0, 0)
+#define VIEWPORT_ATTR	COLOR_ATTR(15, 0)
+#define MARK_ATTR	COLOR_ATTR(14, 0)
+
+/* Quarters of the cell the glyph draws in the foreground color.  */
+static unsigned int glyph_coverage(int ch)
+{
+	switch (ch) {
+	case 0:
+	case ' ':
+	case 255:
+		return 0;
+	case 176:
+		return 1;
+	case 177:
+	case 220:
+	case 221:
+	case 222:
+	case 223:
+		return 2;
+	case 178:
+		return 3;
+	case 219:
+		return 4;
+	default:
+		return 1;
+	}
+}
+
+static unsigned int dominant_color(struct edit_buffer * buf,
+				   unsigned long x0, unsigned long x1,
+				   unsigned long y0, unsigned long y1)
+{
+	unsigned int votes[16] = { 0 };
+	unsigned int best = 0, i;
+	unsigned long x, y;
+
+	for (y = y0; y < y1; y++) {
+		for (x = x0; x < x1; x++) {
+			unsigned int cell = buf->buffer[y * buf->width + x];
+			unsigned int cover = glyph_coverage(cell & 0xff);
+
+			votes[(cell >> 8) & 0x0f] += cover;
+			votes[(cell >> 12) & 0x0f] += 4 - cover;
+		}
+	}
+	for (i = 1; i < 16; i++) {
+		if (votes[i] > votes[best])
+			best = i;
+	}
+	return best;
+}
+
+/* Terminals only take the eight dark colors as background.  */
+static unsigned int half_blocks(unsigned int top, unsigned int bottom)
+{
+	unsigned int bg;
+
+	if (top == bottom && top < 8)
+		return CHAR_ATTR_TO_INT(COLOR_ATTR(7, top), ' ');
+	if (top == bottom)
+		return CHAR_ATTR_TO_INT(COLOR_ATTR(top, 0), 219);
+	if (bottom < 8)
+		return CHAR_ATTR_TO_INT(COLOR_ATTR(top, bottom), 223);
+	if (top < 8)
+		return CHAR_ATTR_TO_INT(COLOR_ATTR(bottom, top), 220);
+
+	bg = bottom & 7;
+	return CHAR_ATTR_TO_INT(COLOR_ATTR(top, bg), 223);
+}
+
+/* One half block cell standing for the cols x rows cells at x, y,
+   clipped to the buffer.  */
+unsigned int minimap_downsample(struct edit_buffer * buf, unsigned long x,
+				unsigned long y, unsigned long cols,
+				unsigned long rows)
+{
+	unsigned long x1 = x + cols, y1 = y + rows;
+	unsigned long mid = y + (rows + 1) / 2;
+
+	if (x1 > buf->width)
+		x1 = buf->width;
+	if (y1 > buf->height)
+		y1 = buf->height;
+	if (mid > y1)
+		mid = y1;
+
+	return half_blocks(dominant_color(buf, x, x1, y, mid),
+			   dominant_color(buf, x, x1, mid, y1));
+}
+
+unsigned long minimap_rows(struct edit_buffer * buf)
+{
+	return (buf->height + MINIMAP_CELL_ROWS - 1) / MINIMAP_CELL_ROWS;
+}
+
+static void minimap_fill_row(struct minimap * map, struct edit_buffer * buf,
+			     unsigned long row)
+{
+	unsigned int * cells = &map->cells[row * map->width];
+	unsigned long col;
+
+	for (col = 0; col < map->width; col++)
+		cells[col] = minimap_downsample(buf, col * MINIMAP_CELL_COLS,
+						row * MINIMAP_CELL_ROWS,
+						MINIMAP_CELL_COLS,
+						MINIMAP_CELL_ROWS);
+}
+
+struct minimap * minimap_create(struct edit_buffer * buf)
+{
+	struct minimap * map = calloc(1, sizeof(struct minimap));
+	unsigned long from, to, row;
+
+	if (!map)
+		error("Could not allocate memory for minimap.");
+
+	map->width = (buf->width + MINIMAP_CELL_COLS - 1) / MINIMAP_CELL_COLS;
+	map->height = minimap_rows(buf);
+	map->cells = malloc(map->width * map->height * sizeof(unsigned int));
+	map->row = malloc((map->width + 2) * sizeof(unsigned int));
+	if (!map->cells || !map->row)
+		error("Could not allocate memory for minimap.");
+
+	edit_buffer_take_changes(buf, &from, &to);
+	for (row = 0; row < map->height; row++)
+		minimap_fill_row(map, buf, row);
+	return map;
+}
+
+void minimap_release(struct minimap * map)
+{
+	free(map->cells);
+	free(map->row);
+	free(map);
+}
+
+void minimap_update(struct minimap * map, struct edit_buffer * buf)
+{
+	unsigned long from, to, row;
+
+	if (!edit_buffer_take_changes(buf, &from, &to))
+		return;
+
+	for (row = from / MINIMAP_CELL_ROWS;
+	     row * MINIMAP_CELL_ROWS < to && row < map->height; row++)
+		minimap_fill_row(map, buf, row);
+}
+
+/* Scroll the minimap to show the rows first to last if it can.  */
+static void minimap_follow(struct minimap * map, unsigned long first,
+			   unsigned long last, unsigned long height)
+{
+	if (last >= map->top + height)
+		map->top = last - height + 1;
+	if (first < map->top)
+		map->top = first;
+	if (map->top + height > map->height)
+		map->top = map->height > height ? map->height - height : 0;
+}
+
+/*
+ *	The minimap is drawn over the right edge of the canvas, with the
+ *	rows under the viewport marked in the border either side and the
+ *	marked row, if any, picked out instead.
+ */
+void minimap_draw(struct minimap * map, struct edit_buffer * buf,
+		  struct screen * scr, unsigned long mark)
+{
+	unsigned long panel_width = map->width + 2;
+	unsigned long first = buf->start_y / MINIMAP_CELL_ROWS;
+	unsigned long last = (buf->start_y + scr->height - 1)
+			     / MINIMAP_CELL_ROWS;
+	unsigned long y, col;
+
+	if (scr->width < panel_width)
+		return;
+
+	if (mark != MINIMAP_NO_MARK)
+		minimap_follow(map, mark, mark, scr->height);
+	else
+		minimap_follow(map, first, last, scr->height);
+
+	for (y = 0; y < scr->height; y++) {
+		unsigned long row = map->top + y;
+		unsigned int left = CHAR_ATTR_TO_INT(BORDER_ATTR, ' ');
+		unsigned int right = left;
+
+		if (row == mark) {
+			left = CHAR_ATTR_TO_INT(MARK_ATTR, 16);
+			right = CHAR_ATTR_TO_INT(MARK_ATTR, 17);
+		} else if (row >= first && row <= last) {
+			left = CHAR_ATTR_TO_INT(VIEWPORT_ATTR, 222);
+			right = CHAR_ATTR_TO_INT(VIEWPORT_ATTR, 221);
+		}
+
+		map->row[0] = left;
+		for (col = 0; col < map->width; col++)
+			map->row[col + 1] = row < map->height
+					    ? map->cells[row * map->width + col]
+					    : CHAR_ATTR_TO_INT(BORDER_ATTR, ' ');
+		map->row[panel_width - 1] = right;
+
+		screen_draw_cells(scr, y, scr->width - panel_width, map->row,
+				  panel_width);
+	}
+}
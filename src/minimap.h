@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _MINIMAP_H
+#define _MINIMAP_H 1
+
+struct edit_buffer;
+struct screen;
+
+/*
+ *	The minimap shows the whole canvas shrunk to one half block cell
+ *	per MINIMAP_CELL_COLS x MINIMAP_CELL_ROWS cells.  Source cells are
+ *	twice as tall as they are wide, so this keeps the proportions of
+ *	the piece.
+ */
+
+#define MINIMAP_CELL_COLS 4
+#define MINIMAP_CELL_ROWS 4
+
+/* No row marked in minimap_draw().  */
+#define MINIMAP_NO_MARK ((unsigned long) -1)
+
+struct minimap {
+	unsigned long width;		/* in cells */
+	unsigned long height;
+	unsigned int * cells;
+	unsigned int * row;		/* one panel row, borders included */
+	unsigned long top;		/* first row on the screen */
+};
+
+struct minimap * minimap_create(struct edit_buffer *);
+void minimap_release(struct minimap *);
+void minimap_update(struct minimap *, struct edit_buffer *);
+void minimap_draw(struct minimap *, struct edit_buffer *, struct screen *,
+		  unsigned long);
+unsigned long minimap_rows(struct edit_buffer *);
+
+unsigned int minimap_downsample(struct edit_buffer *, unsigned long,
+				unsigned long, unsigned long, unsigned long);
+
+#endif
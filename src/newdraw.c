@@ -17,36 +17,46 @@
  */
 
 #include <assert.h>
+#include <ctype.h>
 #include <curses.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <poll.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "ansi-esc.h"
 #include "bin-file.h"
+#include "browse.h"
+#include "bytes.h"
+#include "cell-diff.h"
 #include "colors.h"
 #include "edit-buffer.h"
 #include "editor-context.h"
 #include "error.h"
+#include "event-loop.h"
+#include "font.h"
+#include "html-export.h"
+#include "input.h"
+#include "journal.h"
+#include "keymap.h"
+#include "minimap.h"
+#include "png-export.h"
+#include "save.h"
 #include "screen.h"
-
-/* Curses-like KEY_xxx macro for combining META key with an character.  */
-#define KEY_META(ch) (0x1000 | ch)
-
-static int get_char(void)
-{
-	int ch = getch();
-
-#define META_KEY_CODE 0x1B
-	if (ch == META_KEY_CODE) {
-		/* After META comes the actual key we're interested in.  */
-		ch = KEY_META(getch());
-	}
-	return ch;
-}
+#include "search.h"
+#include "session.h"
+#include "stats.h"
+#include "utf8-export.h"
+#include "viewer.h"
+#include "watch.h"
+#include "zip-pack.h"
 
 static char highascii_sets[15][11] = {
 	{ 218, 191, 192, 217, 196, 179, 195, 180, 193, 194, 197 }, /* single */
@@ -72,42 +82,33 @@ enum {
 
 static unsigned long selected_set = INITIAL_HIGHASCII_SET;
 
-static int get_printable_char(int ch)
-{
-	switch (ch) {
-		case KEY_F(1):
-			return highascii_sets[selected_set][0];
-		case KEY_F(2):
-			return highascii_sets[selected_set][1];
-		case KEY_F(3):
-			return highascii_sets[selected_set][2];
-		case KEY_F(4):
-			return highascii_sets[selected_set][3];
-		case KEY_F(5):
-			return highascii_sets[selected_set][4];
-		case KEY_F(6):
-			return highascii_sets[selected_set][5];
-		case KEY_F(7):
-			return highascii_sets[selected_set][6];
-		case KEY_F(8):
-			return highascii_sets[selected_set][7];
-		case KEY_F(9):
-			return highascii_sets[selected_set][8];
-		case KEY_F(10):
-			return highascii_sets[selected_set][9];
-	}
-	return ch;
-}
-
 /*
  *	Commands issued in the editor
  */
 
-static void cmd_resize(void)
+/* Keep the viewport and the cursor inside the buffer.  */
+static void fit_viewport(struct edit_buffer *buf, struct screen *scr)
 {
-	/* Currently we don't support resizing the terminal while
-	   running.  */
-	error("Terminal was resized.");
+	if (scr->height > buf->height)
+		scr->height = buf->height;
+
+	if (buf->start_y + scr->height > buf->height)
+		buf->start_y = buf->height - scr->height;
+	if (buf->start_x + scr->width > buf->width)
+		buf->start_x = buf->width - scr->width;
+
+	if (scr->cursor_y >= scr->height)
+		scr->cursor_y = scr->height - 1;
+	if (scr->cursor_x >= scr->width)
+		scr->cursor_x = scr->width - 1;
+}
+
+static void cmd_resize(struct edit_buffer *buf, struct screen *scr)
+{
+	screen_resize(scr);
+	session_record_resize(scr->height + 1, scr->width);
+	fit_viewport(buf, scr);
+	screen_redraw();
 }
 
 static void cmd_move_up(struct edit_buffer *buf, struct screen *scr)
@@ -159,10 +160,13 @@ static void cmd_print_char(struct edit_buffer *buf, struct screen *scr,
 {
 	unsigned long attr = COLOR_ATTR(ctx->fg_color, ctx->bg_color);
 
-	edit_buffer_put(buf,
-			buf->start_x + scr->cursor_x,
-			buf->start_y + scr->cursor_y,
-			CHAR_ATTR_TO_INT(attr, get_printable_char(ch)));
+	unsigned long x = buf->start_x + scr->cursor_x;
+	unsigned long y = buf->start_y + scr->cursor_y;
+
+	edit_buffer_put(buf, x, y, CHAR_ATTR_TO_INT(attr, ch));
+	journal_put(x, y, CHAR_ATTR_TO_INT(attr, ch));
+	ctx->modified = true;
+	ctx->generation++;
 }
 
 void cmd_move_page_up(struct edit_buffer *buf, struct screen *scr)
@@ -225,205 +229,1741 @@ static void cmd_prev_bg_color(struct editor_context *ctx)
 	ctx->bg_color = dec_wrap(ctx->bg_color, MAX_BG_COLOR);
 }
 
-static bool cmd_select_highascii_set(int ch)
+/* Set when replaying a session, which must not write files.  */
+static bool read_only = false;
+
+static void cmd_save_file(struct screen * scr, struct edit_buffer * buf,
+			  struct editor_context * ctx)
 {
-#define CASE_SELECT_HIGHASCII_SET(idx) \
-	case KEY_META(KEY_F(idx)): \
-		selected_set = idx - 1; \
-		break; \
-
-	switch (ch) {
-		CASE_SELECT_HIGHASCII_SET(1)
-		CASE_SELECT_HIGHASCII_SET(2)
-		CASE_SELECT_HIGHASCII_SET(3)
-		CASE_SELECT_HIGHASCII_SET(4)
-		CASE_SELECT_HIGHASCII_SET(5)
-		CASE_SELECT_HIGHASCII_SET(6)
-		CASE_SELECT_HIGHASCII_SET(7)
-		CASE_SELECT_HIGHASCII_SET(8)
-		CASE_SELECT_HIGHASCII_SET(9)
-		CASE_SELECT_HIGHASCII_SET(10)
-		default:
-			return false;
+	char * filepath = screen_save_file_dialog(scr);
+
+	if (filepath) {
+		char *filename = strrchr(filepath, '/');
+		if(!filename) { filename = filepath; }
+		
+		char *p = filename;
+		while((p = strchr(p, '\\'))) { *p = '-'; }
+
+		char * save_path = "./art";
+		char *output_path = calloc(1, strlen(filename) + strlen(save_path) + 2);
+		sprintf(output_path, "%s/%s", save_path, filename);
+
+		/* The file is written in the background from a snapshot
+		   and is marked saved once it is on disk.  */
+		if (read_only)
+			ctx->modified = false;
+		else {
+			save_request(edit_buffer_clone(buf), output_path,
+				     ctx->generation);
+			buf->dirty_from = buf->height;
+		}
+		ctx->save_failed = false;
+		free(filepath);
+
+		free(ctx->filename);
+		ctx->filename = output_path;
 	}
-	return true;
 }
 
-static bool cmd_move_cursor(int ch, struct edit_buffer * buf,
-			    struct screen * scr)
+/*
+ *	Macros
+ *
+ *	Keys dispatched while recording are kept so that they can be
+ *	played back up to MAX_MACRO_REPEAT times.  Playback runs the
+ *	commands straight against the edit buffer and the screen is
+ *	painted once afterwards.
+ */
+
+#define MAX_MACRO_KEYS 1024
+#define MAX_MACRO_REPEAT 10000
+
+static int macro[MAX_MACRO_KEYS];
+static unsigned long macro_len;
+
+static bool handle_key(int, struct edit_buffer *, struct screen *,
+		       struct editor_context *);
+
+static void cmd_record_macro(struct editor_context * ctx)
+{
+	ctx->recording_macro = !ctx->recording_macro;
+	if (ctx->recording_macro)
+		macro_len = 0;
+}
+
+static void macro_record_key(const struct keymap_command * cmd, int ch)
 {
-#define CASE_MOVE_CURSOR(key, cmd) \
-	case key: \
-		cmd(buf, scr); \
-		break;
+	if (macro_len < MAX_MACRO_KEYS && cmd->recordable)
+		macro[macro_len++] = ch;
+}
 
-	switch (ch) {
-		CASE_MOVE_CURSOR(KEY_UP,    cmd_move_up)
-		CASE_MOVE_CURSOR(KEY_DOWN,  cmd_move_down)
-		CASE_MOVE_CURSOR(KEY_LEFT,  cmd_move_left)
-		CASE_MOVE_CURSOR(KEY_RIGHT, cmd_move_right)
-		CASE_MOVE_CURSOR(KEY_END,   cmd_move_to_end)
-		CASE_MOVE_CURSOR(KEY_HOME,  cmd_move_to_start)
-		CASE_MOVE_CURSOR(KEY_PPAGE, cmd_move_page_up)
-		CASE_MOVE_CURSOR(KEY_NPAGE, cmd_move_page_down)
-		default:
-			return false;
+static void cmd_play_macro(struct screen * scr, struct edit_buffer * buf,
+			   struct editor_context * ctx)
+{
+	unsigned long count, i, j;
+	char * end;
+
+	if (ctx->recording_macro || macro_len == 0)
+		return;
+
+	char * answer = screen_prompt(scr, "Repeat macro:");
+	if (!answer)
+		return;
+
+	/* Anything but a plain number plays nothing.  */
+	count = strtoul(answer, &end, 10);
+	if (!isdigit((unsigned char) answer[0]) || *end != 0)
+		count = 0;
+	if (count > MAX_MACRO_REPEAT)
+		count = MAX_MACRO_REPEAT;
+	free(answer);
+
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < macro_len; j++)
+			handle_key(macro[j], buf, scr, ctx);
+	}
+	screen_redraw();
+}
+
+/*
+ *	Minimap
+ *
+ *	Jumping to a row shows the minimap and a marker in it, moved with
+ *	the editor's movement keys a minimap row at a time.  Enter moves
+ *	the viewport to the marked rows and any other key gives up.
+ */
+
+static void cmd_jump_to_row(struct edit_buffer * buf, struct screen * scr,
+			    struct editor_context * ctx)
+{
+	ctx->show_minimap = true;
+	ctx->picking_row = true;
+	ctx->picked_row = (buf->start_y + scr->height / 2) / MINIMAP_CELL_ROWS;
+}
+
+/* Centre the viewport on the picked row.  */
+static void jump_to_picked_row(struct edit_buffer * buf, struct screen * scr,
+			       struct editor_context * ctx)
+{
+	unsigned long row = ctx->picked_row * MINIMAP_CELL_ROWS
+			    + MINIMAP_CELL_ROWS / 2;
+
+	buf->start_y = row > scr->height / 2 ? row - scr->height / 2 : 0;
+	if (buf->start_y + scr->height > buf->height)
+		buf->start_y = buf->height - scr->height;
+	screen_redraw();
+}
+
+static void pick_row_key(struct edit_buffer * buf, struct screen * scr,
+			 struct editor_context * ctx, int ch)
+{
+	const char * name = keymap_lookup(ch)->name;
+	unsigned long last = minimap_rows(buf) - 1;
+	unsigned long row = ctx->picked_row;
+
+	if (ch == '\r' || ch == '\n' || ch == KEY_ENTER) {
+		jump_to_picked_row(buf, scr, ctx);
+		ctx->picking_row = false;
+	} else if (strcmp(name, "move_up") == 0) {
+		if (row > 0)
+			row--;
+	} else if (strcmp(name, "move_down") == 0) {
+		if (row < last)
+			row++;
+	} else if (strcmp(name, "page_up") == 0) {
+		row = row > scr->height ? row - scr->height : 0;
+	} else if (strcmp(name, "page_down") == 0) {
+		row = row + scr->height < last ? row + scr->height : last;
+	} else if (strcmp(name, "move_to_start") == 0) {
+		row = 0;
+	} else if (strcmp(name, "move_to_end") == 0) {
+		row = last;
+	} else if (strcmp(name, "resize") == 0) {
+		cmd_resize(buf, scr);
+	} else {
+		ctx->picking_row = false;
+	}
+	ctx->picked_row = row;
+}
+
+/*
+ *	Search
+ *
+ *	Find asks for a query (see search.c) and moves the cursor to the
+ *	next match after it, going round to the top of the canvas after
+ *	the last row.  Find next looks for the same pattern again.
+ */
+
+static struct search_pattern * last_search;
+
+/* Bring x, y into view, centred if the viewport has to move.  */
+static void move_cursor_to(struct edit_buffer * buf, struct screen * scr,
+			   unsigned long x, unsigned long y)
+{
+	if (y < buf->start_y || y >= buf->start_y + scr->height) {
+		buf->start_y = y > scr->height / 2 ? y - scr->height / 2 : 0;
+		if (buf->start_y + scr->height > buf->height)
+			buf->start_y = buf->height - scr->height;
+		screen_redraw();
+	}
+	if (x < buf->start_x || x >= buf->start_x + scr->width) {
+		buf->start_x = x + scr->width > buf->width
+			       ? buf->width - scr->width : x;
+		screen_redraw();
+	}
+	scr->cursor_x = x - buf->start_x;
+	scr->cursor_y = y - buf->start_y;
+}
+
+static void cmd_find_next(struct edit_buffer * buf, struct screen * scr,
+			  struct editor_context * ctx)
+{
+	unsigned long cursor = (buf->start_y + scr->cursor_y) * buf->width
+			       + buf->start_x + scr->cursor_x;
+	unsigned long x, y;
+
+	if (!last_search)
+		return;
+
+	if (search_find(buf, last_search, cursor + 1, &x, &y)
+	    || search_find(buf, last_search, 0, &x, &y))
+		move_cursor_to(buf, scr, x, y);
+	else
+		ctx->search_result = SEARCH_NOT_FOUND;
+}
+
+static void cmd_find(struct edit_buffer * buf, struct screen * scr,
+		     struct editor_context * ctx)
+{
+	struct search_pattern * pattern;
+	char * answer = screen_prompt(scr, "Find:");
+
+	screen_redraw();
+	if (!answer)
+		return;
+
+	pattern = search_compile(answer);
+	free(answer);
+	if (!pattern) {
+		ctx->search_result = SEARCH_BAD_PATTERN;
+		return;
 	}
+
+	if (last_search)
+		search_release(last_search);
+	last_search = pattern;
+	cmd_find_next(buf, scr, ctx);
+}
+
+/*
+ *	Key bindings
+ *
+ *	Each command the keymap can bind wraps one of the commands above.
+ *	The fallback command, the first in the table, prints the key.
+ */
+
+#define BIND_COMMAND(name) \
+	static bool key_##name(struct edit_buffer * buf, struct screen * scr, \
+			       struct editor_context * ctx, int ch)
+
+BIND_COMMAND(print_char)
+{
+	cmd_print_char(buf, scr, ctx, ch);
+	cmd_move_right(buf, scr);
 	return true;
 }
 
-static bool cmd_change_color(int ch, struct editor_context * ctx)
+BIND_COMMAND(backspace)
 {
-#define CASE_CHANGE_COLOR(key, cmd) \
-	case key: \
-		cmd(ctx); \
-		break;
+	cmd_move_left(buf, scr);
+	cmd_print_char(buf, scr, ctx, ' ');
+	return true;
+}
 
-	switch (ch) {
-		CASE_CHANGE_COLOR(KEY_META(KEY_UP),    cmd_next_bg_color)
-		CASE_CHANGE_COLOR(KEY_META(KEY_DOWN),  cmd_prev_bg_color)
-		CASE_CHANGE_COLOR(KEY_META(KEY_RIGHT), cmd_next_fg_color)
-		CASE_CHANGE_COLOR(KEY_META(KEY_LEFT),  cmd_prev_fg_color)
-		default:
-			return false;
+#define MOVE_COMMAND(name) \
+	BIND_COMMAND(name) \
+	{ \
+		cmd_##name(buf, scr); \
+		return true; \
+	}
+
+MOVE_COMMAND(move_up)
+MOVE_COMMAND(move_down)
+MOVE_COMMAND(move_left)
+MOVE_COMMAND(move_right)
+MOVE_COMMAND(move_to_end)
+MOVE_COMMAND(move_to_start)
+MOVE_COMMAND(move_page_up)
+MOVE_COMMAND(move_page_down)
+
+#define COLOR_COMMAND(name) \
+	BIND_COMMAND(name) \
+	{ \
+		cmd_##name(ctx); \
+		return true; \
+	}
+
+COLOR_COMMAND(next_fg_color)
+COLOR_COMMAND(prev_fg_color)
+COLOR_COMMAND(next_bg_color)
+COLOR_COMMAND(prev_bg_color)
+
+#define HIGHASCII_COMMANDS(idx) \
+	BIND_COMMAND(select_set_##idx) \
+	{ \
+		selected_set = idx - 1; \
+		return true; \
+	} \
+	BIND_COMMAND(set_char_##idx) \
+	{ \
+		cmd_print_char(buf, scr, ctx, \
+			       highascii_sets[selected_set][idx - 1]); \
+		cmd_move_right(buf, scr); \
+		return true; \
 	}
+
+HIGHASCII_COMMANDS(1)
+HIGHASCII_COMMANDS(2)
+HIGHASCII_COMMANDS(3)
+HIGHASCII_COMMANDS(4)
+HIGHASCII_COMMANDS(5)
+HIGHASCII_COMMANDS(6)
+HIGHASCII_COMMANDS(7)
+HIGHASCII_COMMANDS(8)
+HIGHASCII_COMMANDS(9)
+HIGHASCII_COMMANDS(10)
+
+BIND_COMMAND(save_file)
+{
+	cmd_save_file(scr, buf, ctx);
 	return true;
 }
 
-static void cmd_save_file(struct screen * scr, struct edit_buffer * buf)
+BIND_COMMAND(toggle_stats)
 {
-	char * filepath = screen_save_file_dialog(scr);
+	ctx->show_stats = !ctx->show_stats;
+	return true;
+}
 
-	if (filepath) {
-		char *filename = strrchr(filepath, '/');
-		if(!filename) { filename = filepath; }
-		
-		char *p = filename;
-		while((p = strchr(p, '\\'))) { *p = '-'; }
+BIND_COMMAND(toggle_minimap)
+{
+	ctx->show_minimap = !ctx->show_minimap;
+	return true;
+}
 
-		char * save_path = "./art";
-		char *output_path = calloc(1, strlen(filename) + strlen(save_path) + 2);
-		sprintf(output_path, "%s/%s", save_path, filename);
-		printf("\n%s\n", output_path);
+BIND_COMMAND(jump_to_row)
+{
+	cmd_jump_to_row(buf, scr, ctx);
+	return true;
+}
 
-		FILE *output = fopen(output_path, "w");
-		if (!output)
-			error("Could not open '%s' for writing.", filename);
+BIND_COMMAND(find)
+{
+	cmd_find(buf, scr, ctx);
+	return true;
+}
 
-		ans_write(output, buf);
+BIND_COMMAND(find_next)
+{
+	cmd_find_next(buf, scr, ctx);
+	return true;
+}
 
-		fclose(output);
-		free(output_path);
-		free(filepath);
+BIND_COMMAND(record_macro)
+{
+	cmd_record_macro(ctx);
+	return true;
+}
+
+BIND_COMMAND(play_macro)
+{
+	cmd_play_macro(scr, buf, ctx);
+	return true;
+}
+
+BIND_COMMAND(resize)
+{
+	cmd_resize(buf, scr);
+	return true;
+}
+
+BIND_COMMAND(quit)
+{
+	return false;
+}
+
+BIND_COMMAND(ignore)
+{
+	return true;
+}
+
+#define HIGHASCII_ENTRIES(idx) \
+	{ "select_set_" #idx,	key_select_set_##idx,	true }, \
+	{ "set_char_" #idx,	key_set_char_##idx,	true },
+
+static const struct keymap_command commands[] = {
+	{ "print_char",		key_print_char,		true },
+	{ "backspace",		key_backspace,		true },
+	{ "move_up",		key_move_up,		true },
+	{ "move_down",		key_move_down,		true },
+	{ "move_left",		key_move_left,		true },
+	{ "move_right",		key_move_right,		true },
+	{ "move_to_end",	key_move_to_end,	true },
+	{ "move_to_start",	key_move_to_start,	true },
+	{ "page_up",		key_move_page_up,	true },
+	{ "page_down",		key_move_page_down,	true },
+	{ "next_fg_color",	key_next_fg_color,	true },
+	{ "prev_fg_color",	key_prev_fg_color,	true },
+	{ "next_bg_color",	key_next_bg_color,	true },
+	{ "prev_bg_color",	key_prev_bg_color,	true },
+	HIGHASCII_ENTRIES(1)
+	HIGHASCII_ENTRIES(2)
+	HIGHASCII_ENTRIES(3)
+	HIGHASCII_ENTRIES(4)
+	HIGHASCII_ENTRIES(5)
+	HIGHASCII_ENTRIES(6)
+	HIGHASCII_ENTRIES(7)
+	HIGHASCII_ENTRIES(8)
+	HIGHASCII_ENTRIES(9)
+	HIGHASCII_ENTRIES(10)
+	{ "save_file",		key_save_file,		false },
+	{ "toggle_stats",	key_toggle_stats,	true },
+	{ "toggle_minimap",	key_toggle_minimap,	true },
+	{ "jump_to_row",	key_jump_to_row,	false },
+	{ "find",		key_find,		false },
+	{ "find_next",		key_find_next,		true },
+	{ "record_macro",	key_record_macro,	false },
+	{ "play_macro",		key_play_macro,		false },
+	{ "resize",		key_resize,		false },
+	/* The player's own keys draw themselves in the editor.  */
+	{ "play_pause",		key_print_char,		true },
+	{ "play_reverse",	key_print_char,		true },
+	{ "play_faster",	key_print_char,		true },
+	{ "play_slower",	key_print_char,		true },
+	{ "step_back",		key_print_char,		true },
+	{ "step_forward",	key_print_char,		true },
+	{ "quit",		key_quit,		false },
+	{ "ignore",		key_ignore,		false }
+};
+
+#define NR_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+#define HIGHASCII_BINDINGS(idx) \
+	{ KEY_META(KEY_F(idx)),	"select_set_" #idx }, \
+	{ KEY_F(idx),		"set_char_" #idx },
+
+static const struct keymap_binding default_bindings[] = {
+	{ KEY_UP,		"move_up" },
+	{ KEY_DOWN,		"move_down" },
+	{ KEY_LEFT,		"move_left" },
+	{ KEY_RIGHT,		"move_right" },
+	{ KEY_END,		"move_to_end" },
+	{ KEY_HOME,		"move_to_start" },
+	{ KEY_PPAGE,		"page_up" },
+	{ KEY_NPAGE,		"page_down" },
+	{ KEY_META(KEY_UP),	"next_bg_color" },
+	{ KEY_META(KEY_DOWN),	"prev_bg_color" },
+	{ KEY_META(KEY_RIGHT),	"next_fg_color" },
+	{ KEY_META(KEY_LEFT),	"prev_fg_color" },
+	HIGHASCII_BINDINGS(1)
+	HIGHASCII_BINDINGS(2)
+	HIGHASCII_BINDINGS(3)
+	HIGHASCII_BINDINGS(4)
+	HIGHASCII_BINDINGS(5)
+	HIGHASCII_BINDINGS(6)
+	HIGHASCII_BINDINGS(7)
+	HIGHASCII_BINDINGS(8)
+	HIGHASCII_BINDINGS(9)
+	HIGHASCII_BINDINGS(10)
+	{ KEY_META('x'),	"quit" },
+	{ KEY_META('X'),	"quit" },
+	{ KEY_META('s'),	"save_file" },
+	{ KEY_META('S'),	"save_file" },
+	{ KEY_META('p'),	"toggle_stats" },
+	{ KEY_META('P'),	"toggle_stats" },
+	{ KEY_META('o'),	"toggle_minimap" },
+	{ KEY_META('O'),	"toggle_minimap" },
+	{ KEY_META('j'),	"jump_to_row" },
+	{ KEY_META('J'),	"jump_to_row" },
+	{ KEY_META('f'),	"find" },
+	{ KEY_META('F'),	"find" },
+	{ KEY_META('n'),	"find_next" },
+	{ KEY_META('N'),	"find_next" },
+	{ KEY_META('r'),	"record_macro" },
+	{ KEY_META('R'),	"record_macro" },
+	{ KEY_META('m'),	"play_macro" },
+	{ KEY_META('M'),	"play_macro" },
+	{ ' ',			"play_pause" },
+	{ 'r',			"play_reverse" },
+	{ '+',			"play_faster" },
+	{ '=',			"play_faster" },
+	{ '-',			"play_slower" },
+	{ ',',			"step_back" },
+	{ '.',			"step_forward" },
+	{ KEY_RESIZE,		"resize" },
+	{ KEY_BACKSPACE,	"backspace" }
+};
+
+#define NR_DEFAULT_BINDINGS \
+	(sizeof(default_bindings) / sizeof(default_bindings[0]))
+
+#define USER_KEYMAP ".newdrawkeys"
+
+/* The user's keymap in the home directory is optional, one given on the
+   command line is not.  */
+static void load_keymap(const char * path)
+{
+	char user_path[PATH_MAX];
+	const char * home;
+
+	keymap_init(commands, NR_COMMANDS, &commands[0],
+		    default_bindings, NR_DEFAULT_BINDINGS);
+
+	if (path) {
+		if (!keymap_load(path))
+			error("Could not read keymap '%s'.", path);
+		return;
 	}
+
+	home = getenv("HOME");
+	if (home && snprintf(user_path, sizeof(user_path), "%s/%s",
+			     home, USER_KEYMAP) < sizeof(user_path))
+		keymap_load(user_path);
 }
 
 /*
  *	Main editor loop
  */
 
-static void edit_loop(struct edit_buffer *buf, struct screen *scr)
+/* Returns false when the editor should quit.  */
+static bool handle_key(int ch, struct edit_buffer * buf, struct screen * scr,
+		       struct editor_context * ctx)
 {
-	struct editor_context ctx = {
-		.fg_color = 0x07,
-		.bg_color = 0x00
-	};
+	const struct keymap_command * cmd;
 
-	bool quit = false;
+	if (ch == ERR)
+		error("Could not read key from terminal.");
 
-	while (!quit) {
-		screen_draw_edit_buffer(scr, buf);
-		screen_print_status(buf, scr, &ctx,
-				    highascii_sets[selected_set]);
-		screen_move(scr->cursor_y, scr->cursor_x);
+	ctx->search_result = SEARCH_NONE;
 
-		int ch = get_char();
-		if (ch == ERR)
-			error("getch() returned ERR");
+	if (ctx->picking_row) {
+		pick_row_key(buf, scr, ctx, ch);
+		return true;
+	}
 
-		if (cmd_select_highascii_set(ch)
-		    || cmd_move_cursor(ch, buf, scr)
-		    || cmd_change_color(ch, &ctx))
-			continue;
+	cmd = keymap_lookup(ch);
+	if (ctx->recording_macro)
+		macro_record_key(cmd, ch);
 
-		switch (ch) {
-			case KEY_META('x'):
-			case KEY_META('X'):
-				quit = true;
-				break;
-			case KEY_META('s'):
-			case KEY_META('S'):
-				cmd_save_file(scr, buf);
-				break;
-			case KEY_RESIZE:
-				cmd_resize();
-				break;
-			case KEY_BACKSPACE:
-				cmd_move_left(buf, scr);
-				cmd_print_char(buf, scr, &ctx, ' ');
-				break;
-			default:
-				cmd_print_char(buf, scr, &ctx, ch);
-				cmd_move_right(buf, scr);
-		}
-	}
+	return cmd->fn(buf, scr, ctx, ch);
 }
 
-static void usage(char * argv[])
+struct editor {
+	struct edit_buffer * buf;
+	struct screen * scr;
+	struct editor_context ctx;
+	bool quit;
+	bool dirty;		/* screen needs to be drawn */
+	unsigned long oldest_key;	/* timestamp of the first key drawn
+					   by the next frame */
+	struct event_timer stats_timer;
+	struct event_timer journal_timer;
+	struct minimap * minimap;	/* made when first shown */
+	struct watch * watch;		/* NULL if not watching the file */
+};
+
+static const char * stats_file;
+
+static void stats_tick(struct event_timer * timer)
 {
-	printf("usage: %s [-h -f -c <columns> -r <rows>] [filename]\n", argv[0]);
+	struct editor * ed = timer->data;
+
+	stats_roll_window();
+	ed->dirty = true;
 }
 
-int main(int argc, char *argv[])
+/* Follow the overlay being switched on and off.  */
+static void update_stats(struct editor * ed)
 {
-	unsigned long edit_buffer_cols = 80;
-	unsigned long edit_buffer_rows = 1000;
-	bool force_ibm_cp437 = false;
+	bool overlay_running = ed->stats_timer.pending;
 
-	for (;;) {
-		int arg_index = getopt(argc, argv, "hfc:r:");
-		if (arg_index == -1) {
+	if (ed->ctx.show_stats && !overlay_running) {
+		stats_roll_window();
+		ed->stats_timer.fn = stats_tick;
+		ed->stats_timer.data = ed;
+		event_loop_add_timer(&ed->stats_timer, 1000, 1000);
+	} else if (!ed->ctx.show_stats && overlay_running)
+		event_loop_del_timer(&ed->stats_timer);
+
+	stats_enabled = ed->ctx.show_stats || stats_file;
+}
+
+/*
+ *	Journal
+ *
+ *	Changes are journaled next to the file from the start of editing
+ *	until they are saved, and the journal is replayed if the editor
+ *	finds one at startup.  It is removed when the editor exits.
+ */
+
+#define UNTITLED_JOURNAL_PATH "./art/untitled.journal"
+#define JOURNAL_SYNC_MS 1000
+
+static char * journal_path(const char * filename)
+{
+	if (!filename)
+		return strdup(UNTITLED_JOURNAL_PATH);
+
+	char * path = calloc(1, strlen(filename) + sizeof(".journal"));
+	sprintf(path, "%s.journal", filename);
+	return path;
+}
+
+/* Set when the canvas was brought back from a journal at startup.  */
+static bool journal_recovered = false;
+
+static void recover_journal(struct edit_buffer * buf, const char * filename)
+{
+	char * path = journal_path(filename);
+	char * rejected;
+
+	journal_recovered = false;
+	switch (journal_recover(path, buf)) {
+		case JOURNAL_NONE:
+			break;
+		case JOURNAL_RECOVERED:
+			journal_recovered = true;
+			break;
+		case JOURNAL_MISMATCH:
+			rejected = calloc(1, strlen(path) + sizeof(".rejected"));
+			sprintf(rejected, "%s.rejected", path);
+			rename(path, rejected);
+			fprintf(stderr, "Journal does not match '%s', moved it "
+				"to '%s'.\n", filename ? filename : "canvas",
+				rejected);
+			free(rejected);
 			break;
-		}
-		switch (arg_index) {
-			case 'h':
-				usage(argv);
-				return EXIT_SUCCESS;
-			case 'f':
-				force_ibm_cp437 = true;
-				break;
-			case 'c':
-				edit_buffer_cols = strtol(optarg, NULL, 10);
-				break;
-			case 'r':
-				edit_buffer_rows = strtol(optarg, NULL, 10);
-				break;
-		default:
-			usage(argv);
-			return EXIT_FAILURE;
-		}
 	}
+	free(path);
+}
 
-	struct edit_buffer *buf =
-		edit_buffer_create(edit_buffer_cols, edit_buffer_rows);
-	edit_buffer_clear(buf);
+static void journal_tick(struct event_timer * timer)
+{
+	journal_sync();
+}
 
-	if (argv[optind] != NULL) {
-		FILE *input = fopen(argv[optind], "r");
-		if (input) {
-			if (bin_file_check(argv[optind]))
-				bin_file_read(input, buf, buf->width);
-			else
-				ans_read(input, buf);
-			fclose(input);
-		}
+/* Journal against the canvas as last saved, or against a snapshot of
+   it if it has changes that are not saved.  */
+static void restart_journal(struct editor * ed, const char * filename,
+			    bool snapshot)
+{
+	char * path = journal_path(filename);
+
+	journal_start(path, ed->buf, snapshot);
+	free(path);
+}
+
+static void save_progressed(void * data)
+{
+	struct editor * ed = data;
+
+	ed->ctx.save_progress = save_progress();
+	ed->dirty = true;
+}
+
+/* The canvas is clean only if nothing changed since the snapshot.  */
+static void save_done(struct save_job * job, void * data)
+{
+	struct editor * ed = data;
+
+	ed->ctx.save_progress = save_progress();
+	ed->ctx.save_failed = !job->ok;
+	if (job->ok && job->generation == ed->ctx.generation)
+		ed->ctx.modified = false;
+	if (job->ok)
+		restart_journal(ed, job->path, ed->ctx.modified);
+	if (job->ok && ed->watch)
+		watch_saved(ed->watch, job->path);
+	ed->dirty = true;
+}
+
+static void editor_draw_minimap(struct editor * ed)
+{
+	if (!ed->minimap)
+		ed->minimap = minimap_create(ed->buf);
+	else
+		minimap_update(ed->minimap, ed->buf);
+
+	minimap_draw(ed->minimap, ed->buf, ed->scr,
+		     ed->ctx.picking_row ? ed->ctx.picked_row
+					 : MINIMAP_NO_MARK);
+}
+
+static void editor_draw(struct editor * ed)
+{
+	unsigned long frame = stats_begin();
+	unsigned long start;
+
+	start = stats_begin();
+	screen_draw_edit_buffer(ed->scr, ed->buf);
+	if (ed->ctx.show_minimap)
+		editor_draw_minimap(ed);
+	stats_end(STATS_DRAW, start);
+
+	if (ed->ctx.show_stats)
+		stats_draw_overlay(ed->scr);
+
+	start = stats_begin();
+	screen_print_status(ed->buf, ed->scr, &ed->ctx,
+			    highascii_sets[selected_set]);
+	stats_end(STATS_STATUS, start);
+
+	start = stats_begin();
+	screen_move(ed->scr->cursor_y, ed->scr->cursor_x);
+	screen_refresh();
+	stats_end(STATS_REFRESH, start);
+
+	stats_end(STATS_FRAME, frame);
+	if (ed->oldest_key) {
+		stats_end(STATS_LATENCY, ed->oldest_key);
+		ed->oldest_key = 0;
 	}
-	struct screen *scr = screen_init(force_ibm_cp437, edit_buffer_cols);
+	stats_frame_done();
+	session_record_frame();
+	journal_flush();
+}
 
-	edit_loop(buf, scr);
+static void editor_input(int fd, short revents, void * data)
+{
+	struct editor * ed = data;
+	struct input_event event;
+	bool got_key = false;
 
-	edit_buffer_release(buf);
-	screen_release(scr);
+	/* Apply everything that arrived during the last frame before
+	   drawing the next one.  */
+	while (!ed->quit) {
+		unsigned long start = stats_begin();
+		bool more = input_poll();
+
+		stats_end(STATS_INPUT, start);
+		if (!more)
+			break;
+
+		while (!ed->quit && input_next_event(&event)) {
+			if (!ed->oldest_key)
+				ed->oldest_key = event.timestamp;
+
+			start = stats_begin();
+			ed->quit = !handle_key(event.key, ed->buf, ed->scr,
+					       &ed->ctx);
+			stats_end(STATS_DISPATCH, start);
+		}
+		got_key = true;
+	}
+	update_stats(ed);
+
+	/* Readable but nothing to read means the terminal went away.  */
+	if (!got_key && (revents & (POLLERR | POLLHUP)))
+		error("Could not read key from terminal.");
+
+	ed->dirty = true;
+}
+
+static void editor_resize(void * data)
+{
+	struct editor * ed = data;
+
+	cmd_resize(ed->buf, ed->scr);
+	ed->dirty = true;
+}
+
+/*
+ *	Autosave
+ *
+ *	A snapshot of a modified buffer is written to <file>.autosave
+ *	every so often.  The writing is done a few rows at a time while
+ *	the editor is idle.
+ */
+
+#define AUTOSAVE_ROWS_PER_SLICE 32
+#define UNTITLED_AUTOSAVE_PATH "./art/untitled.autosave"
+
+static struct {
+	struct event_timer timer;
+	struct event_idle idle;
+	struct edit_buffer * snapshot;
+	FILE * output;
+	unsigned long row;
+	unsigned long generation;	/* of the last snapshot */
+} autosave;
+
+static char * autosave_path(struct editor_context * ctx)
+{
+	if (!ctx->filename)
+		return strdup(UNTITLED_AUTOSAVE_PATH);
+
+	char * path = calloc(1, strlen(ctx->filename) + sizeof(".autosave"));
+	sprintf(path, "%s.autosave", ctx->filename);
+	return path;
+}
+
+static bool autosave_slice(struct event_idle * idle)
+{
+	unsigned long last = autosave.row + AUTOSAVE_ROWS_PER_SLICE;
+
+	ans_write_rows(autosave.output, autosave.snapshot, autosave.row, last);
+	autosave.row = last;
+
+	if (last < autosave.snapshot->max_height)
+		return true;
+
+	fclose(autosave.output);
+	autosave.output = NULL;
+	edit_buffer_release(autosave.snapshot);
+	autosave.snapshot = NULL;
+	return false;
+}
+
+static void autosave_tick(struct event_timer * timer)
+{
+	struct editor * ed = timer->data;
+
+	if (autosave.snapshot || !ed->ctx.modified
+	    || ed->ctx.generation == autosave.generation)
+		return;
+
+	/* Autosave is best effort; try again next time.  */
+	char * path = autosave_path(&ed->ctx);
+	autosave.output = fopen(path, "w");
+	free(path);
+	if (!autosave.output)
+		return;
+
+	autosave.snapshot = edit_buffer_clone(ed->buf);
+	autosave.generation = ed->ctx.generation;
+	autosave.row = 0;
+	event_loop_add_idle(&autosave.idle);
+}
+
+static void autosave_start(struct editor * ed, unsigned long seconds)
+{
+	if (seconds == 0)
+		return;
+
+	autosave.timer.fn = autosave_tick;
+	autosave.timer.data = ed;
+	autosave.idle.fn = autosave_slice;
+	event_loop_add_timer(&autosave.timer, seconds * 1000, seconds * 1000);
+}
+
+static void autosave_stop(void)
+{
+	event_loop_del_timer(&autosave.timer);
+
+	/* Don't leave a half written file behind.  */
+	while (autosave.snapshot && autosave_slice(&autosave.idle))
+		;
+}
+
+static void editor_init(struct editor * ed, struct edit_buffer * buf,
+			struct screen * scr, const char * filename)
+{
+	memset(ed, 0, sizeof(*ed));
+
+	ed->buf = buf;
+	ed->scr = scr;
+	ed->ctx.fg_color = 0x07;
+	ed->ctx.bg_color = 0x00;
+	ed->ctx.filename = filename ? strdup(filename) : NULL;
+	ed->ctx.modified = false;
+	ed->ctx.save_progress = -1;
+	ed->quit = false;
+	ed->dirty = true;
+
+	fit_viewport(buf, scr);
+}
+
+static const char * record_path;
+
+static void record_start(struct editor * ed)
+{
+	struct session_header header = {
+		.buf_width  = ed->buf->width,
+		.buf_height = ed->buf->height,
+		.rows       = ed->scr->height + 1,
+		.cols       = ed->scr->width,
+		.hash       = edit_buffer_hash(ed->buf),
+		.filename   = ed->ctx.filename
+	};
+
+	if (!session_record_open(record_path, &header))
+		error("Could not open '%s' for recording.", record_path);
+	input_set_tap(session_record_key);
+}
+
+/*
+ *	Watching
+ *
+ *	With --watch, changes other programs save to the file show up in
+ *	the canvas as they happen.  Only the rows from the first changed
+ *	byte on are read again, and only the cells that changed are drawn
+ *	over, so the view stays where it is and the rest of the canvas
+ *	keeps what was drawn on it.
+ */
+
+static bool watch_file;
+
+static void file_changed(int fd, short revents, void * data)
+{
+	struct editor * ed = data;
+
+	if (!watch_reload(ed->watch, ed->buf))
+		return;
+
+	/* What is on disk now is not a change of ours, but the journal
+	   has to start again from it.  */
+	restart_journal(ed, ed->ctx.filename, ed->ctx.modified);
+	ed->dirty = true;
+}
+
+static void edit_loop(struct edit_buffer *buf, struct screen *scr,
+		      const char * filename, unsigned long autosave_interval,
+		      struct watch * watch)
+{
+	struct editor ed;
+
+	editor_init(&ed, buf, scr, filename);
+	if (record_path)
+		record_start(&ed);
+	ed.watch = watch;
+
+	ed.ctx.modified = journal_recovered;
+	restart_journal(&ed, filename, journal_recovered);
+	ed.journal_timer.fn = journal_tick;
+	event_loop_add_timer(&ed.journal_timer, JOURNAL_SYNC_MS,
+			     JOURNAL_SYNC_MS);
+
+	input_start();
+	save_init(save_progressed, save_done, &ed);
+	event_loop_watch_fd(input_fd(), editor_input, &ed);
+	event_loop_on_resize(editor_resize, &ed);
+	if (watch)
+		event_loop_watch_fd(watch_fd(watch), file_changed, &ed);
+	autosave_start(&ed, autosave_interval);
+	update_stats(&ed);
+
+	while (!ed.quit) {
+		if (ed.dirty) {
+			editor_draw(&ed);
+			ed.dirty = false;
+		}
+		event_loop_run_once();
+	}
+
+	event_loop_del_timer(&ed.stats_timer);
+	autosave_stop();
+	event_loop_on_resize(NULL, NULL);
+	event_loop_unwatch_fd(input_fd());
+	if (watch)
+		event_loop_unwatch_fd(watch_fd(watch));
+	input_stop();
+	save_release();
+	event_loop_del_timer(&ed.journal_timer);
+	journal_close();
+
+	if (record_path) {
+		input_set_tap(NULL);
+		session_record_close(edit_buffer_hash(buf));
+	}
+	if (ed.minimap)
+		minimap_release(ed.minimap);
+	free(ed.ctx.filename);
+}
+
+/*
+ *	Session replay
+ *
+ *	A recorded session is fed through handle_key() on a headless
+ *	screen, drawing a frame wherever the session drew one, as fast as
+ *	possible or at the recorded pace.  The time spent is reported per
+ *	command and the final canvas is checked against the recording.
+ */
+
+#define MAX_REPLAY_COSTS 32
+
+struct replay_cost {
+	const char * name;
+	unsigned long count;
+	unsigned long total_ns;
+	unsigned long max_ns;
+};
+
+static struct replay_cost replay_costs[MAX_REPLAY_COSTS];
+static unsigned long nr_replay_costs;
+
+static void replay_cost_add(const char * name, unsigned long ns)
+{
+	unsigned long i;
+
+	for (i = 0; i < nr_replay_costs; i++) {
+		if (replay_costs[i].name == name)
+			break;
+	}
+	if (i == nr_replay_costs) {
+		if (nr_replay_costs == MAX_REPLAY_COSTS)
+			return;
+		replay_costs[nr_replay_costs++].name = name;
+	}
+
+	struct replay_cost * cost = &replay_costs[i];
+	cost->count++;
+	cost->total_ns += ns;
+	if (ns > cost->max_ns)
+		cost->max_ns = ns;
+}
+
+static void replay_cost_print(struct replay_cost * cost)
+{
+	printf("%-14s %8lu %12.1f %10.2f %10.1f\n", cost->name, cost->count,
+	       cost->total_ns / 1000.0,
+	       cost->count ? cost->total_ns / 1000.0 / cost->count : 0.0,
+	       cost->max_ns / 1000.0);
+}
+
+/* Keys consumed so far, prompts included.  */
+static unsigned long replayed_keys;
+
+static void count_replayed_key(const struct input_event * event)
+{
+	replayed_keys++;
+}
+
+static void sleep_until(unsigned long ns)
+{
+	struct timespec ts = {
+		.tv_sec  = ns / 1000000000UL,
+		.tv_nsec = ns % 1000000000UL
+	};
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+		;
+}
+
+/* Files in art packs are read without extracting them.  */
+static FILE * open_art(const char * filename)
+{
+	const struct zip_member * member;
+	const char * member_name;
+	struct zip_pack * pack;
+	char * pack_path;
+	FILE * input;
+
+	input = fopen(filename, "r");
+	if (input)
+		return input;
+
+	pack_path = zip_pack_split_path(filename, &member_name);
+	if (!pack_path)
+		return NULL;
+
+	pack = zip_pack_open(pack_path);
+	free(pack_path);
+	if (!pack)
+		return NULL;
+
+	member = zip_pack_find(pack, member_name);
+	if (member)
+		input = zip_pack_open_member(pack, member);
+	zip_pack_close(pack);
+	return input;
+}
+
+static bool load_file(struct edit_buffer * buf, const char * filename)
+{
+	FILE *input = open_art(filename);
+	if (!input)
+		return false;
+
+	if (bin_file_check(filename))
+		bin_file_read(input, buf, buf->width);
+	else
+		ans_read(input, buf);
+	fclose(input);
+	return true;
+}
+
+static int replay_session(const char * log_path, const char * filename,
+			  const struct screen_backend * backend,
+			  enum screen_charset charset, bool realtime)
+{
+	struct session_header header;
+	struct session_record * records = NULL;
+	unsigned long nr_records = 0, max_records = 0;
+	unsigned long i;
+
+	if (!session_replay_open(log_path, &header)) {
+		fprintf(stderr, "Could not read session log '%s'.\n", log_path);
+		return EXIT_FAILURE;
+	}
+
+	do {
+		if (nr_records == max_records) {
+			max_records = max_records ? max_records * 2 : 1024;
+			records = realloc(records, max_records
+					  * sizeof(struct session_record));
+			if (!records)
+				error("Could not allocate memory for session.");
+		}
+		if (!session_replay_next(&records[nr_records])) {
+			fprintf(stderr, "Session log '%s' is truncated.\n",
+				log_path);
+			return EXIT_FAILURE;
+		}
+	} while (records[nr_records++].type != SESSION_END);
+	session_replay_close();
+
+	/* Prompts read their keys through the input layer, so all keys
+	   are replayed from there.  */
+	int * keys = malloc(nr_records * sizeof(int));
+	unsigned long nr_keys = 0;
+	if (!keys)
+		error("Could not allocate memory for session.");
+
+	for (i = 0; i < nr_records; i++) {
+		if (records[i].type == SESSION_KEY)
+			keys[nr_keys++] = records[i].key;
+	}
+
+	if (!filename)
+		filename = header.filename;
+
+	struct edit_buffer * buf =
+		edit_buffer_create(header.buf_width, header.buf_height);
+	edit_buffer_clear(buf);
+	if (filename)
+		load_file(buf, filename);
+
+	if (edit_buffer_hash(buf) != header.hash)
+		fprintf(stderr, "warning: canvas differs from the one the "
+			"session started from\n");
+
+	int null_fd = open("/dev/null", O_WRONLY);
+	screen_set_headless(null_fd, header.rows, header.cols);
+
+	struct screen * scr = screen_init(backend, charset, header.buf_width);
+	struct editor ed;
+
+	editor_init(&ed, buf, scr, filename);
+	read_only = true;
+	input_set_script(keys, nr_keys);
+	input_set_tap(count_replayed_key);
+
+	unsigned long start = input_now();
+	unsigned long offset_us = 0;
+	unsigned long key_index = 0;
+
+	for (i = 0; i < nr_records && !ed.quit; i++) {
+		struct session_record * record = &records[i];
+		unsigned long t;
+
+		switch (record->type) {
+			case SESSION_KEY:
+				offset_us += record->delay_us;
+
+				/* Already read by a prompt.  */
+				if (key_index++ < replayed_keys)
+					break;
+
+				if (realtime)
+					sleep_until(start + offset_us * 1000);
+
+				t = input_now();
+				int key = input_get_key();
+				ed.quit = !handle_key(key, buf, scr, &ed.ctx);
+				replay_cost_add(keymap_lookup(key)->name,
+						input_now() - t);
+				break;
+			case SESSION_FRAME:
+				t = input_now();
+				editor_draw(&ed);
+				replay_cost_add("(frame)", input_now() - t);
+				break;
+			case SESSION_RESIZE:
+				screen_set_headless(null_fd, record->rows,
+						    record->cols);
+				cmd_resize(buf, scr);
+				break;
+			case SESSION_END:
+				break;
+		}
+	}
+
+	unsigned long elapsed = input_now() - start;
+	unsigned long long hash = edit_buffer_hash(buf);
+	unsigned long long expected = records[nr_records - 1].hash;
+
+	printf("replayed %lu keys in %.3f ms (recorded session %.3f s)\n\n",
+	       replayed_keys, elapsed / 1000000.0, offset_us / 1000000.0);
+	printf("%-14s %8s %12s %10s %10s\n",
+	       "command", "count", "total us", "mean us", "max us");
+	for (i = 0; i < nr_replay_costs; i++)
+		replay_cost_print(&replay_costs[i]);
+	printf("\ncanvas %016llx ", hash);
+	if (hash == expected)
+		printf("matches the recording\n");
+	else
+		printf("differs from the recording (%016llx)\n", expected);
+
+	input_set_tap(NULL);
+	input_set_script(NULL, 0);
+	if (ed.minimap)
+		minimap_release(ed.minimap);
+	free(ed.ctx.filename);
+	edit_buffer_release(buf);
+	screen_release(scr);
+	close(null_fd);
+	free(header.filename);
+	free(keys);
+	free(records);
+
+	return hash == expected ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int list_pack(const char * path)
+{
+	struct zip_pack * pack = zip_pack_open(path);
+	unsigned long i;
+
+	if (!pack) {
+		fprintf(stderr, "Could not read ZIP file '%s'.\n", path);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < pack->nr_members; i++)
+		printf("%10lu  %s/%s\n", pack->members[i].size, path,
+		       pack->members[i].name);
+
+	zip_pack_close(pack);
+	return EXIT_SUCCESS;
+}
+
+/* Load the file into a fresh canvas, or NULL if it cannot be read.  */
+static struct edit_buffer * load_canvas(const char * filename,
+					unsigned long cols, unsigned long rows)
+{
+	struct edit_buffer * buf = edit_buffer_create(cols, rows);
+
+	edit_buffer_clear(buf);
+	if (!load_file(buf, filename)) {
+		fprintf(stderr, "Could not open '%s'.\n", filename);
+		edit_buffer_release(buf);
+		return NULL;
+	}
+	return buf;
+}
+
+enum export_format {
+	EXPORT_PNG,
+	EXPORT_HTML,
+	EXPORT_UTF8
+};
+
+/* Export the file to path, or to standard output if path is "-".  */
+static int export_file(enum export_format format, const char * path,
+		       const char * filename, const struct font * font,
+		       bool truecolor, unsigned long cols, unsigned long rows)
+{
+	struct edit_buffer * buf = load_canvas(filename, cols, rows);
+	const char * name = strrchr(filename, '/');
+	FILE * output;
+	bool ok = false;
+
+	if (!buf)
+		return EXIT_FAILURE;
+
+	output = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+	if (!output) {
+		fprintf(stderr, "Could not open '%s'.\n", path);
+		edit_buffer_release(buf);
+		return EXIT_FAILURE;
+	}
+
+	switch (format) {
+		case EXPORT_PNG:
+			ok = png_export(output, buf, font);
+			break;
+		case EXPORT_HTML:
+			ok = html_export(output, buf, name ? name + 1 : filename);
+			break;
+		case EXPORT_UTF8:
+			ok = utf8_export(output, buf, truecolor);
+			break;
+	}
+	if (output != stdout && fclose(output) != 0)
+		ok = false;
+	if (!ok)
+		fprintf(stderr, "Could not write '%s'.\n", path);
+
+	edit_buffer_release(buf);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ *	Diffing
+ *
+ *	Like diff(1), --diff exits with 0 if the files are the same, 1 if
+ *	they differ and 2 if something went wrong.
+ */
+
+static int diff_files(const char * path_a, const char * path_b,
+		      const char * patch_path, bool view,
+		      const struct screen_backend * backend,
+		      enum screen_charset charset, unsigned long cols,
+		      unsigned long rows)
+{
+	struct cell_diff diff = { 0, 0, NULL, 0 };
+	struct edit_buffer * a, * b;
+	int ret = EXIT_FAILURE;
+	unsigned long i;
+
+	a = load_canvas(path_a, cols, rows);
+	b = a ? load_canvas(path_b, cols, rows) : NULL;
+	if (!b) {
+		if (a)
+			edit_buffer_release(a);
+		return 2;
+	}
+
+	cell_diff(a, b, &diff);
+
+	if (patch_path) {
+		FILE * output = strcmp(patch_path, "-") == 0
+				? stdout : fopen(patch_path, "wb");
+		bool ok = output && patch_write(output, a, b, &diff);
+
+		if (output && output != stdout && fclose(output) != 0)
+			ok = false;
+		if (!ok) {
+			fprintf(stderr, "Could not write '%s'.\n", patch_path);
+			ret = 2;
+			goto out;
+		}
+	} else if (view) {
+		view_diff(a, b, &diff, path_a, path_b, backend, charset);
+	} else {
+		for (i = 0; i < diff.nr_rects; i++)
+			printf("%lu,%lu %lux%lu\n", diff.rects[i].x + 1,
+			       diff.rects[i].y + 1, diff.rects[i].width,
+			       diff.rects[i].height);
+		if (diff.nr_rects > 0)
+			printf("%lu cells differ in %lu rectangles\n",
+			       diff.nr_cells, diff.nr_rects);
+	}
+	ret = view || diff.nr_rects == 0 ? 0 : 1;
+out:
+	cell_diff_release(&diff);
+	edit_buffer_release(a);
+	edit_buffer_release(b);
+	return ret;
+}
+
+/* Apply the patch to the file and write the result to standard output.  */
+static int apply_patch(const char * patch_path, const char * filename,
+		       unsigned long cols, unsigned long rows)
+{
+	struct edit_buffer * buf;
+	unsigned char * patch;
+	unsigned long len = 0;
+	enum patch_status status;
+
+	patch = bytes_read_file(patch_path, &len);
+	if (!patch) {
+		fprintf(stderr, "Could not read patch '%s'.\n", patch_path);
+		return EXIT_FAILURE;
+	}
+	buf = load_canvas(filename, cols, rows);
+	if (!buf) {
+		free(patch);
+		return EXIT_FAILURE;
+	}
+
+	status = patch_apply(patch, len, buf);
+	if (status == PATCH_APPLIED)
+		ans_write(stdout, buf);
+	else if (status == PATCH_MISMATCH)
+		fprintf(stderr, "Patch '%s' was not made against '%s'.\n",
+			patch_path, filename);
+	else
+		fprintf(stderr, "Patch '%s' is corrupt.\n", patch_path);
+
+	free(patch);
+	edit_buffer_release(buf);
+	return status == PATCH_APPLIED ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ *	Grep
+ *
+ *	Like grep(1), --grep exits with 0 if anything was found, 1 if not
+ *	and 2 if something went wrong.
+ */
+
+static int grep_art(const char * query, const char * piece, const char * dir,
+		    unsigned long cols, unsigned long rows)
+{
+	struct search_pattern * pattern;
+	unsigned long nr_matches;
+
+	if (piece) {
+		struct edit_buffer * buf = load_canvas(piece, cols, rows);
+
+		if (!buf)
+			return 2;
+		pattern = search_from_canvas(buf);
+		edit_buffer_release(buf);
+		if (!pattern) {
+			fprintf(stderr, "Nothing is drawn in '%s'.\n", piece);
+			return 2;
+		}
+	} else {
+		pattern = search_compile(query);
+		if (!pattern) {
+			fprintf(stderr, "Bad search pattern '%s'.\n", query);
+			return 2;
+		}
+	}
+
+	nr_matches = search_grep(dir, pattern, load_file, cols, rows);
+	search_release(pattern);
+	return nr_matches > 0 ? 0 : 1;
+}
+
+static void edit_file(const char * filename,
+		      const struct screen_backend * backend,
+		      enum screen_charset charset, unsigned long cols,
+		      unsigned long rows, unsigned long autosave_interval)
+{
+	struct edit_buffer *buf = edit_buffer_create(cols, rows);
+	edit_buffer_clear(buf);
+
+	struct watch * watch = NULL;
+
+	if (filename != NULL)
+		load_file(buf, filename);
+	recover_journal(buf, filename);
+
+	if (watch_file && filename) {
+		watch = watch_start(filename, buf);
+		if (!watch)
+			fprintf(stderr, "Could not watch '%s'.\n", filename);
+	}
+
+	/* Before the screen so that the event loop gets SIGWINCH.  */
+	event_loop_init();
+
+	struct screen *scr = screen_init(backend, charset, cols);
+
+	edit_loop(buf, scr, filename, autosave_interval, watch);
+
+	if (watch)
+		watch_stop(watch);
+	edit_buffer_release(buf);
+	screen_release(scr);
+	event_loop_release();
+}
+
+static void usage(char * argv[])
+{
+	printf("usage: %s [-h -f -u -b <backend> -c <columns> -r <rows> "
+	       "-a <seconds> -k <keymap> --stats-file <path> --record <log> "
+	       "--replay <log> --realtime --view --list --render-png <png> "
+	       "--font <font> --export-html <html> --export-utf8 --truecolor "
+	       "--browse --diff --patch <patch> --apply <patch> --grep <query> "
+	       "--grep-art <piece> --watch --play --baud <rate>] "
+	       "[filename | directory | file1 file2]\n", argv[0]);
+}
+
+enum {
+	OPT_STATS_FILE = 256,
+	OPT_RECORD,
+	OPT_REPLAY,
+	OPT_REALTIME,
+	OPT_VIEW,
+	OPT_LIST,
+	OPT_RENDER_PNG,
+	OPT_FONT,
+	OPT_EXPORT_HTML,
+	OPT_EXPORT_UTF8,
+	OPT_TRUECOLOR,
+	OPT_BROWSE,
+	OPT_DIFF,
+	OPT_PATCH,
+	OPT_APPLY,
+	OPT_GREP,
+	OPT_GREP_ART,
+	OPT_WATCH,
+	OPT_PLAY,
+	OPT_BAUD
+};
+
+static const struct option long_options[] = {
+	{ "stats-file",	required_argument, NULL, OPT_STATS_FILE },
+	{ "record",	required_argument, NULL, OPT_RECORD },
+	{ "replay",	required_argument, NULL, OPT_REPLAY },
+	{ "realtime",	no_argument,	   NULL, OPT_REALTIME },
+	{ "view",	no_argument,	   NULL, OPT_VIEW },
+	{ "list",	no_argument,	   NULL, OPT_LIST },
+	{ "render-png",	required_argument, NULL, OPT_RENDER_PNG },
+	{ "font",	required_argument, NULL, OPT_FONT },
+	{ "export-html", required_argument, NULL, OPT_EXPORT_HTML },
+	{ "export-utf8", no_argument,	   NULL, OPT_EXPORT_UTF8 },
+	{ "truecolor",	no_argument,	   NULL, OPT_TRUECOLOR },
+	{ "browse",	no_argument,	   NULL, OPT_BROWSE },
+	{ "diff",	no_argument,	   NULL, OPT_DIFF },
+	{ "patch",	required_argument, NULL, OPT_PATCH },
+	{ "apply",	required_argument, NULL, OPT_APPLY },
+	{ "grep",	required_argument, NULL, OPT_GREP },
+	{ "grep-art",	required_argument, NULL, OPT_GREP_ART },
+	{ "watch",	no_argument,	   NULL, OPT_WATCH },
+	{ "play",	no_argument,	   NULL, OPT_PLAY },
+	{ "baud",	required_argument, NULL, OPT_BAUD },
+	{ NULL,		0,		   NULL, 0 }
+};
+
+int main(int argc, char *argv[])
+{
+	unsigned long edit_buffer_cols = 80;
+	unsigned long edit_buffer_rows = 1000;
+	enum screen_charset charset = SCREEN_CHARSET_NATIVE;
+	const struct screen_backend * backend = NULL;
+	unsigned long autosave_interval = 0;
+	const char * replay_path = NULL;
+	const char * keymap_path = NULL;
+	bool realtime = false;
+	bool view = false;
+	bool list = false;
+	bool browse = false;
+	bool diff = false;
+	bool play = false;
+	unsigned long baud = 28800;
+	const char * patch_path = NULL;
+	const char * apply_path = NULL;
+	const char * grep_query = NULL;
+	const char * grep_piece = NULL;
+	enum export_format export_format = EXPORT_PNG;
+	const char * export_path = NULL;
+	bool truecolor = false;
+	const struct font * font = &font_8x16;
+
+	for (;;) {
+		int arg_index = getopt_long(argc, argv, "hfub:c:r:a:k:",
+					    long_options, NULL);
+		if (arg_index == -1) {
+			break;
+		}
+		switch (arg_index) {
+			case 'h':
+				usage(argv);
+				return EXIT_SUCCESS;
+			case 'f':
+				charset = SCREEN_CHARSET_FORCE_CP437;
+				break;
+			case 'u':
+				charset = SCREEN_CHARSET_UTF8;
+				break;
+			case 'b':
+				backend = screen_backend_lookup(optarg);
+				if (!backend) {
+					printf("unknown backend '%s'\n", optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+			case 'c':
+				edit_buffer_cols = strtol(optarg, NULL, 10);
+				break;
+			case 'r':
+				edit_buffer_rows = strtol(optarg, NULL, 10);
+				break;
+			case 'a':
+				autosave_interval = strtol(optarg, NULL, 10);
+				break;
+			case 'k':
+				keymap_path = optarg;
+				break;
+			case OPT_STATS_FILE:
+				stats_file = optarg;
+				break;
+			case OPT_RECORD:
+				record_path = optarg;
+				break;
+			case OPT_REPLAY:
+				replay_path = optarg;
+				break;
+			case OPT_REALTIME:
+				realtime = true;
+				break;
+			case OPT_VIEW:
+				view = true;
+				break;
+			case OPT_LIST:
+				list = true;
+				break;
+			case OPT_RENDER_PNG:
+				export_format = EXPORT_PNG;
+				export_path = optarg;
+				break;
+			case OPT_FONT:
+				font = font_lookup(optarg);
+				if (!font) {
+					printf("unknown font '%s'\n", optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+			case OPT_EXPORT_HTML:
+				export_format = EXPORT_HTML;
+				export_path = optarg;
+				break;
+			case OPT_EXPORT_UTF8:
+				export_format = EXPORT_UTF8;
+				export_path = "-";
+				break;
+			case OPT_TRUECOLOR:
+				truecolor = true;
+				break;
+			case OPT_BROWSE:
+				browse = true;
+				break;
+			case OPT_DIFF:
+				diff = true;
+				break;
+			case OPT_PATCH:
+				patch_path = optarg;
+				break;
+			case OPT_APPLY:
+				apply_path = optarg;
+				break;
+			case OPT_GREP:
+				grep_query = optarg;
+				break;
+			case OPT_GREP_ART:
+				grep_piece = optarg;
+				break;
+			case OPT_WATCH:
+				watch_file = true;
+				break;
+			case OPT_PLAY:
+				play = true;
+				break;
+			case OPT_BAUD:
+				baud = strtoul(optarg, NULL, 10);
+				if (baud == 0) {
+					printf("bad baud rate '%s'\n", optarg);
+					return EXIT_FAILURE;
+				}
+				break;
+		default:
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (list) {
+		if (!argv[optind]) {
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+		return list_pack(argv[optind]);
+	}
+
+	if (export_path) {
+		if (!argv[optind]) {
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+		return export_file(export_format, export_path, argv[optind],
+				   font, truecolor, edit_buffer_cols,
+				   edit_buffer_rows);
+	}
+
+	if (grep_query || grep_piece)
+		return grep_art(grep_query, grep_piece,
+				argv[optind] ? argv[optind] : ".",
+				edit_buffer_cols, edit_buffer_rows);
+
+	if (apply_path) {
+		if (!argv[optind]) {
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+		return apply_patch(apply_path, argv[optind], edit_buffer_cols,
+				   edit_buffer_rows);
+	}
+
+	if (diff && !view) {
+		if (optind + 2 != argc) {
+			usage(argv);
+			return 2;
+		}
+		return diff_files(argv[optind], argv[optind + 1], patch_path,
+				  false, NULL, charset, edit_buffer_cols,
+				  edit_buffer_rows);
+	}
+
+	load_keymap(keymap_path);
+
+	if (replay_path)
+		return replay_session(replay_path, argv[optind],
+				      backend ? backend : &screen_mem_backend,
+				      charset, realtime);
+
+	if (!backend)
+		backend = &screen_raw_backend;
+
+	if (view && diff) {
+		if (optind + 2 != argc) {
+			usage(argv);
+			return 2;
+		}
+		return diff_files(argv[optind], argv[optind + 1], NULL, true,
+				  backend, charset, edit_buffer_cols,
+				  edit_buffer_rows);
+	}
+
+	if (play) {
+		if (!argv[optind]) {
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+		return play_file(argv[optind], backend, charset, baud,
+				 edit_buffer_rows);
+	}
+
+	if (view) {
+		if (!argv[optind]) {
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+		return view_file(argv[optind], backend, charset);
+	}
+
+	if (browse) {
+		const char * dir = argv[optind] ? argv[optind] : ".";
+		struct browser * browser = browser_create(dir, load_file);
+		char * path;
+
+		while ((path = browser_run(browser, backend, charset))) {
+			edit_file(path, backend, charset, edit_buffer_cols,
+				  edit_buffer_rows, autosave_interval);
+			free(path);
+		}
+		browser_release(browser);
+	} else {
+		edit_file(argv[optind], backend, charset, edit_buffer_cols,
+			  edit_buffer_rows, autosave_interval);
+	}
+
+	if (stats_file && !stats_dump(stats_file))
+		fprintf(stderr, "Could not write stats to '%s'.\n",
+			stats_file);
 
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "colors.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "font.h"
+#include "png-export.h"
+
+/*
+ *	PNG export
+ *
+ *	The canvas is drawn with a bitmap font in the VGA palette into a
+ *	4-bit indexed PNG, one text row at a time.  Each text row is
+ *	rasterized into a band of pixel rows that is compressed straight
+ *	into the IDAT chunks, so the whole image is never in memory.
+ */
+
+/*
+ *	Glyph rows
+ *
+ *	At four bits a pixel, a glyph row of eight pixels is one 32-bit
+ *	word.  pixel_masks[] has the word for every glyph row byte with
+ *	all four bits of the pixels that are set, so a row is drawn as
+ *	(fg & mask) | (bg & ~mask) with fg and bg repeated in every
+ *	nibble.  The words are built in memory order so that they can be
+ *	stored as they are.
+ */
+
+static uint32_t pixel_masks[256];
+static uint32_t color_words[16];
+
+static void init_masks(void)
+{
+	unsigned char bytes[4];
+	int bits, i;
+
+	if (pixel_masks[0xff])
+		return;
+
+	for (bits = 0; bits < 256; bits++) {
+		for (i = 0; i < 4; i++)
+			bytes[i] = (bits & (0x80 >> (2 * i)) ? 0xf0 : 0)
+				 | (bits & (0x40 >> (2 * i)) ? 0x0f : 0);
+		memcpy(&pixel_masks[bits], bytes, sizeof(uint32_t));
+	}
+	for (i = 0; i < 16; i++)
+		memset(&color_words[i], i * 0x11, sizeof(uint32_t));
+}
+
+/* Draw text row y into height pixel rows of stride bytes each.  */
+static void rasterize_row(struct edit_buffer * buf, unsigned long y,
+			  const struct font * font, unsigned char * band,
+			  unsigned long stride)
+{
+	const unsigned int * cell = &buf->buffer[y * buf->width];
+	unsigned long x;
+	unsigned int i;
+
+	for (i = 0; i < font->height; i++)
+		band[i * stride] = 0;		/* no filter */
+
+	for (x = 0; x < buf->width; x++) {
+		const unsigned char * glyph =
+			&font->glyphs[(cell[x] & 0xff) * font->height];
+		uint32_t fg = color_words[(cell[x] >> 8) & 0x0f];
+		uint32_t bg = color_words[(cell[x] >> 12) & 0x0f];
+		unsigned char * out = band + 1 + x * sizeof(uint32_t);
+
+		for (i = 0; i < font->height; i++) {
+			uint32_t mask = pixel_masks[glyph[i]];
+			uint32_t pixels = (fg & mask) | (bg & ~mask);
+
+			memcpy(out + i * stride, &pixels, sizeof(uint32_t));
+		}
+	}
+}
+
+/*
+ *	Chunks
+ */
+
+#define IDAT_SIZE 65536
+
+static void put32(unsigned char * p, unsigned long value)
+{
+	p[0] = value >> 24;
+	p[1] = value >> 16;
+	p[2] = value >> 8;
+	p[3] = value;
+}
+
+static bool write_chunk(FILE * output, const char * type,
+			const unsigned char * data, unsigned long len)
+{
+	unsigned char word[4];
+	unsigned long crc;
+
+	crc = crc32(0, (const Bytef *) type, 4);
+	if (len)
+		crc = crc32(crc, data, len);
+
+	put32(word, len);
+	if (fwrite(word, 4, 1, output) != 1 || fwrite(type, 4, 1, output) != 1
+	    || (len && fwrite(data, len, 1, output) != 1))
+		return false;
+	put32(word, crc);
+	return fwrite(word, 4, 1, output) == 1;
+}
+
+/* Compress data into the stream and write out every IDAT filled.  */
+static bool deflate_band(FILE * output, z_stream * z, unsigned char * idat,
+			 unsigned char * data, unsigned long len, int flush)
+{
+	int ret;
+
+	z->next_in = data;
+	z->avail_in = len;
+	do {
+		ret = deflate(z, flush);
+		if (ret == Z_STREAM_ERROR)
+			return false;
+		if (z->avail_out == 0 || (flush == Z_FINISH && z->avail_out
+					  < IDAT_SIZE)) {
+			if (!write_chunk(output, "IDAT", idat,
+					 IDAT_SIZE - z->avail_out))
+				return false;
+			z->next_out = idat;
+			z->avail_out = IDAT_SIZE;
+		}
+	} while (z->avail_in > 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+	return true;
+}
+
+bool png_export(FILE * output, struct edit_buffer * buf,
+		const struct font * font)
+{
+	static const unsigned char signature[8] = {
+		0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+	};
+	unsigned long rows = buf->max_height ? buf->max_height : 1;
+	unsigned long stride = 1 + buf->width * sizeof(uint32_t);
+	unsigned char header[13], palette[16 * 3];
+	unsigned char * band, * idat;
+	unsigned long y;
+	z_stream z;
+	bool ok;
+
+	init_masks();
+
+	put32(header, buf->width * 8);
+	put32(header + 4, rows * font->height);
+	header[8] = 4;			/* bits per pixel */
+	header[9] = 3;			/* palette */
+	header[10] = header[11] = header[12] = 0;
+	memcpy(palette, vga_palette, sizeof(palette));
+
+	band = malloc(stride * font->height);
+	idat = malloc(IDAT_SIZE);
+	if (!band || !idat)
+		error("Could not allocate memory for PNG export.");
+
+	/* Glyph rows repeat all over a piece, so even the fastest level
+	   finds most of them.  */
+	memset(&z, 0, sizeof(z));
+	if (deflateInit2(&z, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS, 9,
+			 Z_DEFAULT_STRATEGY) != Z_OK)
+		error("Could not allocate memory for PNG export.");
+	z.next_out = idat;
+	z.avail_out = IDAT_SIZE;
+
+	ok = fwrite(signature, sizeof(signature), 1, output) == 1
+	     && write_chunk(output, "IHDR", header, sizeof(header))
+	     && write_chunk(output, "PLTE", palette, sizeof(palette));
+
+	for (y = 0; ok && y < rows; y++) {
+		rasterize_row(buf, y, font, band, stride);
+		ok = deflate_band(output, &z, idat, band,
+				  stride * font->height,
+				  y + 1 == rows ? Z_FINISH : Z_NO_FLUSH);
+	}
+
+	ok = ok && write_chunk(output, "IEND", NULL, 0);
+
+	deflateEnd(&z);
+	free(band);
+	free(idat);
+	return ok && fflush(output) == 0 && !ferror(output);
+}
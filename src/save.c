@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ansi-esc.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "event-loop.h"
+#include "html-export.h"
+#include "save.h"
+
+/*
+ *	Save worker
+ *
+ *	One job is written at a time and one more can wait for it.  A
+ *	request made while a job is waiting replaces that job, since the
+ *	newer snapshot supersedes it.  Progress is kept in percent and the
+ *	event loop is told whenever it changes.
+ */
+
+#define SAVE_ROWS_PER_CHUNK 64
+
+static pthread_mutex_t save_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t save_cond = PTHREAD_COND_INITIALIZER;
+static struct save_job * waiting;
+static bool stopping;
+
+static bool thread_started = false;
+static pthread_t save_thread;
+
+static atomic_int progress = -1;
+static mode_t new_file_mode;
+
+static void (*progress_fn)(void *);
+static void (*done_fn)(struct save_job *, void *);
+static void * callback_data;
+
+static void free_job(struct save_job * job)
+{
+	edit_buffer_release(job->buf);
+	free(job->path);
+	free(job);
+}
+
+static void notify_progress(void * unused)
+{
+	if (progress_fn)
+		progress_fn(callback_data);
+}
+
+static void notify_done(void * data)
+{
+	struct save_job * job = data;
+
+	if (done_fn)
+		done_fn(job, callback_data);
+	free_job(job);
+}
+
+static void set_progress(int pct)
+{
+	if (atomic_exchange(&progress, pct) != pct)
+		event_loop_complete(notify_progress, NULL);
+}
+
+/* In the same directory as the file so that rename() is atomic.  */
+static char * temp_path(const char * path)
+{
+	const char * name = strrchr(path, '/');
+	int dir_len = name ? name - path + 1 : 0;
+	char * tmp = malloc(strlen(path) + sizeof("..XXXXXX"));
+
+	if (!tmp)
+		error("Could not allocate memory for file name.");
+
+	sprintf(tmp, "%.*s.%s.XXXXXX", dir_len, path, path + dir_len);
+	return tmp;
+}
+
+/* Make the rename itself durable.  Not every file system can.  */
+static void sync_dir(const char * path)
+{
+	const char * name = strrchr(path, '/');
+	char * dir = strndup(path, name ? name - path + 1 : 0);
+	int fd;
+
+	if (!dir)
+		return;
+
+	fd = open(*dir ? dir : ".", O_RDONLY | O_DIRECTORY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+	free(dir);
+}
+
+/*
+ *	Row index
+ *
+ *	Byte offsets of the rows in the file saved last.  A row is encoded
+ *	without regard to the rows before it, so when the next save goes
+ *	to the same file, untouched since, the rows in front of the first
+ *	one that changed are copied over from it rather than encoded again.
+ *	Only the worker uses the index.
+ */
+
+static struct {
+	char * path;			/* NULL if there is no index */
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+	unsigned long nr_rows;
+	unsigned long * offsets;	/* nr_rows + 1 of them */
+	unsigned long max_rows;
+} row_index;
+
+static void index_reserve(unsigned long nr_rows)
+{
+	if (nr_rows + 1 <= row_index.max_rows)
+		return;
+
+	row_index.max_rows = nr_rows + 1;
+	row_index.offsets = realloc(row_index.offsets, row_index.max_rows
+				    * sizeof(unsigned long));
+	if (!row_index.offsets)
+		error("Could not allocate memory for row index.");
+}
+
+static void index_drop(void)
+{
+	free(row_index.path);
+	row_index.path = NULL;
+}
+
+/* Rows that can be kept from the file on disk.  */
+static unsigned long index_unchanged_rows(struct save_job * job)
+{
+	struct edit_buffer * buf = job->buf;
+	unsigned long rows = buf->dirty_from;
+	struct stat st;
+
+	if (!row_index.path || strcmp(row_index.path, job->path) != 0
+	    || stat(job->path, &st) != 0
+	    || st.st_dev != row_index.dev || st.st_ino != row_index.ino
+	    || st.st_size != row_index.size
+	    || st.st_mtim.tv_sec != row_index.mtime.tv_sec
+	    || st.st_mtim.tv_nsec != row_index.mtime.tv_nsec)
+		return 0;
+
+	if (rows > row_index.nr_rows)
+		rows = row_index.nr_rows;
+	if (rows > buf->max_height)
+		rows = buf->max_height;
+	return rows;
+}
+
+/* Copy the first len bytes of the file at path to fd.  */
+static bool copy_prefix(const char * path, int fd, unsigned long len)
+{
+	char chunk[65536];
+	int in = open(path, O_RDONLY);
+	bool ok = true;
+
+	if (in < 0)
+		return false;
+
+	while (len > 0) {
+		ssize_t ret = copy_file_range(in, NULL, fd, NULL, len, 0);
+
+		if (ret < 0 && (errno == ENOSYS || errno == EXDEV
+				|| errno == EINVAL || errno == EOPNOTSUPP)) {
+			ret = read(in, chunk, len < sizeof(chunk)
+						   ? len : sizeof(chunk));
+			if (ret > 0 && write(fd, chunk, ret) != ret)
+				ret = -1;
+		}
+		if (ret <= 0) {
+			ok = false;
+			break;
+		}
+		len -= ret;
+	}
+	close(in);
+	return ok;
+}
+
+static bool write_rows(FILE * output, struct edit_buffer * buf,
+		       unsigned long first)
+{
+	unsigned long total = buf->max_height - first;
+	unsigned long y, pos = first ? row_index.offsets[first] : 0;
+
+	for (y = first; y < buf->max_height; y++) {
+		row_index.offsets[y] = pos;
+		pos += ans_write_rows(output, buf, y, y + 1);
+
+		if ((y + 1 - first) % SAVE_ROWS_PER_CHUNK == 0)
+			set_progress((y + 1 - first) * 100 / total);
+	}
+	row_index.offsets[buf->max_height] = pos;
+	return !ferror(output);
+}
+
+/* HTML pages are written whole and have no row index.  */
+static bool write_html(FILE * output, struct edit_buffer * buf,
+		       const char * path)
+{
+	const char * name = strrchr(path, '/');
+
+	return html_export(output, buf, name ? name + 1 : path);
+}
+
+static bool write_job(struct save_job * job)
+{
+	struct edit_buffer * buf = job->buf;
+	bool html = html_check(job->path);
+	unsigned long first = html ? 0 : index_unchanged_rows(job);
+	char * tmp = temp_path(job->path);
+	FILE * output = NULL;
+	struct stat st;
+	int fd, ret;
+
+	/* Good for the rows kept until the save is done.  */
+	index_drop();
+	index_reserve(buf->max_height);
+
+	fd = mkstemp(tmp);
+	if (fd < 0)
+		goto fail;
+
+	/* Keep the permissions of the file being replaced.  */
+	fchmod(fd, stat(job->path, &st) == 0 ? st.st_mode & 07777
+					      : new_file_mode);
+
+	if (first > 0 && !copy_prefix(job->path, fd,
+				      row_index.offsets[first]))
+		goto fail;
+
+	output = fdopen(fd, "w");
+	if (!output)
+		goto fail;
+
+	if (!(html ? write_html(output, buf, job->path)
+		   : write_rows(output, buf, first)))
+		goto fail;
+	set_progress(100);
+
+	if (fflush(output) != 0 || fsync(fd) != 0 || fstat(fd, &st) != 0)
+		goto fail;
+
+	ret = fclose(output);
+	output = NULL;
+	if (ret != 0 || rename(tmp, job->path) != 0)
+		goto fail;
+
+	sync_dir(job->path);
+	free(tmp);
+
+	if (html)
+		return true;
+
+	row_index.path = strdup(job->path);
+	row_index.dev = st.st_dev;
+	row_index.ino = st.st_ino;
+	row_index.size = st.st_size;
+	row_index.mtime = st.st_mtim;
+	row_index.nr_rows = buf->max_height;
+	return true;
+
+fail:
+	job->error = errno;
+	if (output)
+		fclose(output);
+	else if (fd >= 0)
+		close(fd);
+	if (fd >= 0)
+		unlink(tmp);
+	free(tmp);
+	return false;
+}
+
+static void * save_thread_fn(void * unused)
+{
+	pthread_mutex_lock(&save_lock);
+	for (;;) {
+		while (!waiting && !stopping)
+			pthread_cond_wait(&save_cond, &save_lock);
+
+		/* Waiting jobs are written before stopping.  */
+		struct save_job * job = waiting;
+		if (!job)
+			break;
+		waiting = NULL;
+		pthread_mutex_unlock(&save_lock);
+
+		set_progress(0);
+		job->ok = write_job(job);
+		atomic_store(&progress, -1);
+		event_loop_complete(notify_done, job);
+
+		pthread_mutex_lock(&save_lock);
+	}
+	pthread_mutex_unlock(&save_lock);
+	return NULL;
+}
+
+void save_init(void (*on_progress)(void *),
+	       void (*on_done)(struct save_job *, void *), void * data)
+{
+	mode_t mask = umask(0);
+
+	umask(mask);
+	new_file_mode = 0666 & ~mask;
+
+	progress_fn = on_progress;
+	done_fn = on_done;
+	callback_data = data;
+
+	stopping = false;
+	if (pthread_create(&save_thread, NULL, save_thread_fn, NULL) != 0)
+		error("Could not create save thread.");
+	thread_started = true;
+}
+
+/* Finishes any saves that are still in flight.  */
+void save_release(void)
+{
+	if (!thread_started)
+		return;
+
+	pthread_mutex_lock(&save_lock);
+	stopping = true;
+	pthread_cond_signal(&save_cond);
+	pthread_mutex_unlock(&save_lock);
+
+	pthread_join(save_thread, NULL);
+	thread_started = false;
+
+	/* Completions that are still queued outlive the editor.  */
+	progress_fn = NULL;
+	done_fn = NULL;
+	callback_data = NULL;
+}
+
+/* Write the snapshot to path.  The job takes ownership of the buffer.  */
+void save_request(struct edit_buffer * buf, const char * path,
+		  unsigned long generation)
+{
+	struct save_job * job = calloc(1, sizeof(struct save_job));
+	struct save_job * replaced;
+
+	if (!job)
+		error("Could not allocate memory for save.");
+
+	job->buf = buf;
+	job->path = strdup(path);
+	job->generation = generation;
+	if (!job->path)
+		error("Could not allocate memory for file name.");
+
+	pthread_mutex_lock(&save_lock);
+	replaced = waiting;
+	/* Rows changed in the snapshot being replaced are still to save.  */
+	if (replaced && replaced->buf->dirty_from < buf->dirty_from)
+		buf->dirty_from = replaced->buf->dirty_from;
+	waiting = job;
+	pthread_cond_signal(&save_cond);
+	pthread_mutex_unlock(&save_lock);
+
+	if (replaced)
+		free_job(replaced);
+}
+
+/* Percent of the current save written, or -1 if there is none.  */
+int save_progress(void)
+{
+	return atomic_load(&progress);
+}
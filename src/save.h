@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _SAVE_H
+#define _SAVE_H 1
+
+#include <stdbool.h>
+
+struct edit_buffer;
+
+/*
+ *	Saves run on a worker thread against a snapshot of the canvas.
+ *	The file is written next to its destination and renamed over it
+ *	once it is safely on disk, so a failed save leaves the old file
+ *	alone.
+ */
+struct save_job {
+	struct edit_buffer * buf;	/* snapshot, owned by the job */
+	char * path;
+	unsigned long generation;	/* of the canvas in the snapshot */
+	bool ok;
+	int error;			/* errno if the save failed */
+};
+
+/* Both callbacks are run on the event loop thread.  */
+void save_init(void (*)(void *), void (*)(struct save_job *, void *),
+	       void *);
+void save_release(void);
+
+void save_request(struct edit_buffer *, const char *, unsigned long);
+int save_progress(void);
+
+#endif
@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#define NCURSES_WIDECHAR 1
+
+#include <assert.h>
+#include <curses.h>
+#include <ctype.h>
+#include <form.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <wchar.h>
+
+#include "colors.h"
+#include "cp437.h"
+#include "error.h"
+#include "input.h"
+#include "screen.h"
+
+/*
+ *	ncurses screen backend
+ */
+
+static void init_curses(void)
+{
+	savetty();
+
+	if (initscr() == NULL)
+		error("Could not initialize screen.");
+
+	nonl();
+	cbreak();
+	noecho();
+	keypad(stdscr, TRUE);
+
+	if (has_colors() == FALSE) {
+		error("Your terminal doesn't support colors.");
+	}
+	start_color();
+}
+
+static void release_curses(void)
+{
+	resetty();
+	endwin();
+}
+
+/* Edit buffer attribute -> curses attribute lookup table.  The color
+   pairs are looked up as the cells are drawn (see color_pair()).  */
+static attr_t attr_to_attrs[256];
+
+static void init_attr_table(void)
+{
+	int attribute;
+
+	for (attribute = 0; attribute < 256; attribute++)
+		attr_to_attrs[attribute] = (attribute & 0x08) ? A_BOLD : 0;
+}
+
+/* Wide character strings for the CP437 characters in UTF-8 mode.  */
+static wchar_t glyph_wchars[256][2];
+
+static void init_glyph_table(void)
+{
+	int ch;
+
+	for (ch = 0; ch < 256; ch++) {
+		glyph_wchars[ch][0] = cp437_to_unicode[ch];
+		glyph_wchars[ch][1] = 0;
+	}
+}
+
+static bool curses_init(struct screen * scr)
+{
+	/* Wide character output needs the locale's encoding.  */
+	if (cp437_utf8) {
+		setlocale(LC_ALL, "");
+		init_glyph_table();
+	}
+
+	init_curses();
+	init_color_pairs();
+	init_attr_table();
+
+	getmaxyx(stdscr, scr->height, scr->width);
+	if (scr->height == -1 || scr->width == -1)
+		error("Could not get screen dimensions from curses.");
+
+	return true;
+}
+
+static void curses_release(void)
+{
+	release_curses();
+}
+
+static void curses_resize(struct screen * scr)
+{
+	struct winsize ws;
+
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0
+	    && ws.ws_row && ws.ws_col)
+		resize_term(ws.ws_row, ws.ws_col);
+
+	getmaxyx(stdscr, scr->height, scr->width);
+	clearok(curscr, TRUE);
+}
+
+#define MAX_ROW_LEN 1024
+
+static void draw_cells_wide(unsigned long y, unsigned long x,
+			    const unsigned int * cells, unsigned long len)
+{
+	cchar_t row[MAX_ROW_LEN];
+	unsigned long i;
+
+	for (i = 0; i < len; i++) {
+		int attribute = (cells[i] & 0xFF00) >> 8;
+		int character = cells[i] & 0xFF;
+
+		setcchar(&row[i], glyph_wchars[character],
+			 attr_to_attrs[attribute], color_pair(attribute),
+			 NULL);
+	}
+	mvadd_wchnstr(y, x, row, len);
+}
+
+static void curses_draw_cells(unsigned long y, unsigned long x,
+			      const unsigned int * cells, unsigned long len)
+{
+	chtype row[MAX_ROW_LEN];
+	unsigned long i;
+
+	if (len > MAX_ROW_LEN)
+		len = MAX_ROW_LEN;
+
+	if (cp437_utf8) {
+		draw_cells_wide(y, x, cells, len);
+		return;
+	}
+
+	for (i = 0; i < len; i++) {
+		int attribute = (cells[i] & 0xFF00) >> 8;
+		int character = cells[i] & 0xFF;
+
+		row[i] = (unsigned char) cp437_glyphs[character].bytes[0]
+			| attr_to_attrs[attribute]
+			| COLOR_PAIR(color_pair(attribute));
+	}
+	mvaddchnstr(y, x, row, len);
+}
+
+static void curses_move(unsigned long y, unsigned long x)
+{
+	move(y, x);
+}
+
+static void curses_refresh(void)
+{
+	refresh();
+	color_pairs_next_frame();
+}
+
+static void curses_redraw(void)
+{
+	redrawwin(stdscr);
+}
+
+static int curses_get_key(void)
+{
+	return getch();
+}
+
+static void curses_nodelay(bool on)
+{
+	nodelay(stdscr, on);
+}
+
+static char * trim_trailing(const char * str)
+{
+	unsigned long len;
+	for (len = strlen(str); len > 0 && isspace(str[len - 1]); len--)
+		;;
+
+	char * ret = malloc(len + 1);
+	strncpy(ret, str, len);
+	ret[len] = 0;
+
+	return ret;
+}
+
+static char * curses_prompt(struct screen * scr, const char * text)
+{
+	assume_default_colors(7, COLOR_BLACK);
+
+#define PROMPT_TEXT_LEN strlen(text)
+#define PROMPT_FIELD_LEN 25
+
+#define CENTER_START ((scr->width - PROMPT_FIELD_LEN - PROMPT_TEXT_LEN) / 2)
+
+	FIELD * fields[2];
+
+	fields[0] = new_field(1, PROMPT_FIELD_LEN, scr->height / 2,
+			      CENTER_START + PROMPT_TEXT_LEN + 1, 0, 0);
+	fields[1] = NULL;
+
+	set_field_back(fields[0], A_UNDERLINE);
+
+	FORM * form = new_form(fields);
+	post_form(form);
+	refresh();
+
+	mvprintw(scr->height / 2, CENTER_START, "%s", text);
+	mvprintw(1, 1, "Press Enter to accept; double ESC to exit screen.");
+
+#define FORM_KEY_ENTER 13
+#define FORM_KEY_ESC   27
+#define FORM_KEY_BACKSPACE 127
+
+	/* Keys come decoded through the input layer, so double ESC is
+	   META-ESC.  */
+	bool quit = false;
+	while (!quit) {
+		int ch = input_get_key();
+		switch (ch) {
+			case FORM_KEY_ENTER:
+				form_driver(form, REQ_END_FIELD);
+				quit = true;
+				break;
+			case ERR:
+			case KEY_META(FORM_KEY_ESC):
+				/* Don't end field so we get an empty
+				   string.  */
+				quit = true;
+				break;
+			case FORM_KEY_BACKSPACE:
+			case KEY_BACKSPACE:
+				form_driver(form, REQ_DEL_PREV);
+				break;
+			default:
+				form_driver(form, ch);
+				break;
+		}
+	}
+
+	char * ret = trim_trailing(field_buffer(fields[0], 0));
+	if (strlen(ret) == 0) {
+		free(ret);
+		ret = NULL;
+	}
+
+	unpost_form(form);
+	free_form(form);
+	free_field(fields[0]);
+
+	assume_default_colors(0, COLOR_BLACK);
+
+	return ret;
+}
+
+static void curses_restore(void)
+{
+	endwin();
+}
+
+const struct screen_backend screen_curses_backend = {
+	.name           = "curses",
+	.init           = curses_init,
+	.release        = curses_release,
+	.resize         = curses_resize,
+	.draw_cells     = curses_draw_cells,
+	.move           = curses_move,
+	.refresh        = curses_refresh,
+	.redraw         = curses_redraw,
+	.threaded_input = false,
+	.get_key        = curses_get_key,
+	.nodelay        = curses_nodelay,
+	.prompt         = curses_prompt,
+	.restore        = curses_restore
+};
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "colors.h"
+#include "cp437.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "input.h"
+#include "screen.h"
+
+/*
+ *	In-memory screen backend
+ *
+ *	Keeps the cells that would be displayed in a framebuffer and
+ *	reads keys from a script.  Used for benchmarking and replaying
+ *	sessions without a terminal.  Every changed cell is counted as
+ *	the bytes of its glyph.
+ */
+
+#define DEFAULT_HEIGHT 25
+#define DEFAULT_WIDTH  80
+
+static unsigned long rows;
+static unsigned long cols;
+
+static unsigned int * framebuffer;
+
+static const int * keys;
+static unsigned long nr_keys;
+
+void screen_mem_feed_keys(const int * script, unsigned long len)
+{
+	keys = script;
+	nr_keys = len;
+}
+
+unsigned int screen_mem_get_cell(unsigned long y, unsigned long x)
+{
+	if (!framebuffer || y >= rows || x >= cols)
+		return 0;
+
+	return framebuffer[y * cols + x];
+}
+
+static void alloc_framebuffer(void)
+{
+	framebuffer = malloc(rows * cols * sizeof(unsigned int));
+	if (!framebuffer)
+		error("Could not allocate memory for screen.");
+
+	unsigned long i;
+	for (i = 0; i < rows * cols; i++)
+		framebuffer[i] = CHAR_ATTR_TO_INT(COLOR_ATTR(7, 0), ' ');
+}
+
+static bool mem_init(struct screen * scr)
+{
+	int fd;
+
+	if (!screen_get_headless(&fd, &rows, &cols)) {
+		rows = DEFAULT_HEIGHT;
+		cols = DEFAULT_WIDTH;
+	}
+	alloc_framebuffer();
+
+	scr->height = rows;
+	scr->width  = cols;
+
+	return true;
+}
+
+static void mem_release(void)
+{
+	free(framebuffer);
+	framebuffer = NULL;
+}
+
+/* Takes the new size from screen_set_headless().  */
+static void mem_resize(struct screen * scr)
+{
+	int fd;
+
+	if (screen_get_headless(&fd, &rows, &cols)) {
+		free(framebuffer);
+		alloc_framebuffer();
+	}
+
+	scr->height = rows;
+	scr->width  = cols;
+}
+
+static void mem_draw_cells(unsigned long y, unsigned long x,
+			   const unsigned int * cells, unsigned long len)
+{
+	unsigned long i;
+
+	if (y >= rows || x >= cols)
+		return;
+
+	if (x + len > cols)
+		len = cols - x;
+
+	unsigned int * dst = framebuffer + y * cols + x;
+	for (i = 0; i < len; i++) {
+		if (dst[i] != cells[i]) {
+			dst[i] = cells[i];
+			screen_stats.bytes_out +=
+				cp437_glyphs[cells[i] & 0xFF].len;
+		}
+	}
+}
+
+static void mem_move(unsigned long y, unsigned long x)
+{
+}
+
+static void mem_refresh(void)
+{
+}
+
+static void mem_redraw(void)
+{
+}
+
+static int mem_get_key(void)
+{
+	if (nr_keys == 0)
+		return ERR;
+
+	nr_keys--;
+	return *keys++;
+}
+
+static void mem_nodelay(bool on)
+{
+}
+
+#define PROMPT_FIELD_LEN 25
+
+/* Take the keys typed into the prompt like the terminal backends do,
+   without drawing anything.  */
+static char * mem_prompt(struct screen * scr, const char * text)
+{
+	char field[PROMPT_FIELD_LEN + 1];
+	unsigned long len = 0;
+
+	for (;;) {
+		int ch = input_get_key();
+
+		if (ch == ERR || ch == KEY_META(27))
+			return NULL;
+		if (ch == '\r')
+			break;
+
+		if (ch == KEY_BACKSPACE) {
+			if (len > 0)
+				len--;
+		} else if (ch >= 0x20 && ch < 0x7F && len < PROMPT_FIELD_LEN)
+			field[len++] = ch;
+	}
+
+	while (len > 0 && field[len - 1] == ' ')
+		len--;
+
+	if (len == 0)
+		return NULL;
+
+	field[len] = 0;
+	return strdup(field);
+}
+
+static void mem_restore(void)
+{
+}
+
+const struct screen_backend screen_mem_backend = {
+	.name           = "mem",
+	.init           = mem_init,
+	.release        = mem_release,
+	.resize         = mem_resize,
+	.draw_cells     = mem_draw_cells,
+	.move           = mem_move,
+	.refresh        = mem_refresh,
+	.redraw         = mem_redraw,
+	.threaded_input = false,
+	.get_key        = mem_get_key,
+	.nodelay        = mem_nodelay,
+	.prompt         = mem_prompt,
+	.restore        = mem_restore
+};
@@ -0,0 +1,666 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "colors.h"
+#include "cp437.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "input.h"
+#include "screen.h"
+
+/*
+ *	Raw VT100 screen backend
+ *
+ *	Cells drawn during a frame go to a back buffer.  On refresh the
+ *	back buffer is compared against the front buffer, which mirrors
+ *	what is on the terminal, and the escape sequences for the cells
+ *	that differ are composed into a preallocated output buffer that
+ *	is flushed with a single write().
+ */
+
+#define INVALID_CELL 0xFFFFFFFF
+#define UNKNOWN_POS  ((unsigned long) -1)
+
+static int in_fd  = STDIN_FILENO;
+static int out_fd = STDOUT_FILENO;
+
+static struct termios saved_termios;
+
+static unsigned long rows;
+static unsigned long cols;
+
+static unsigned int * front;
+static unsigned int * back;
+
+static char * out;
+static unsigned long out_len;
+
+/* Where the program wants the cursor to be after a refresh.  */
+static unsigned long cursor_y;
+static unsigned long cursor_x;
+
+/* What the terminal currently has.  */
+static unsigned long term_y = UNKNOWN_POS;
+static unsigned long term_x = UNKNOWN_POS;
+static int term_attr = -1;
+
+/*
+ *	Output buffer
+ */
+
+/* Worst case is cursor movement plus attribute change for every cell.  */
+#define MAX_CELL_OUTPUT 32
+#define MAX_FRAME_OVERHEAD 64
+
+static void out_str(const char * str, unsigned long len)
+{
+	memcpy(out + out_len, str, len);
+	out_len += len;
+}
+
+#define OUT_LITERAL(str) out_str(str, sizeof(str) - 1)
+
+static void out_num(unsigned long num)
+{
+	char digits[20];
+	int i = 0;
+
+	do {
+		digits[i++] = '0' + num % 10;
+		num /= 10;
+	} while (num > 0);
+
+	while (i > 0)
+		out[out_len++] = digits[--i];
+}
+
+static void out_move(unsigned long y, unsigned long x)
+{
+	OUT_LITERAL("\x1B[");
+	out_num(y + 1);
+	out[out_len++] = ';';
+	out_num(x + 1);
+	out[out_len++] = 'H';
+
+	term_y = y;
+	term_x = x;
+}
+
+static void out_param(bool * first, unsigned long param)
+{
+	if (!*first)
+		out[out_len++] = ';';
+	*first = false;
+	out_num(param);
+}
+
+/* Emit only the attributes that differ from what the terminal has.  */
+static void out_attr(int attr)
+{
+	int fg_color = attr & 0x0F;
+	int bg_color = (attr & 0xF0) >> 4;
+	bool first = true;
+
+	OUT_LITERAL("\x1B[");
+	if (term_attr < 0) {
+		out_param(&first, 0);
+		if (fg_color & 0x08)
+			out_param(&first, 1);
+	} else if ((term_attr & 0x08) != (fg_color & 0x08))
+		out_param(&first, (fg_color & 0x08) ? 1 : 22);
+
+	if (term_attr < 0 || (term_attr & 0x07) != (fg_color & 0x07))
+		out_param(&first, 30 + (fg_color & 0x07));
+
+	/* Bright backgrounds (iCE colors) as aixterm bright colors.  */
+	if (term_attr < 0 || ((term_attr & 0xF0) >> 4) != bg_color)
+		out_param(&first, bg_color < 8 ? 40 + bg_color
+					       : 100 + bg_color - 8);
+
+	out[out_len++] = 'm';
+
+	term_attr = attr;
+}
+
+static void out_cell(unsigned int cell)
+{
+	int attr = (cell & 0xFF00) >> 8;
+	struct cp437_glyph * glyph = &cp437_glyphs[cell & 0xFF];
+
+	if (attr != term_attr)
+		out_attr(attr);
+
+	/* Glyphs are at most four bytes; always copy all of them.  */
+	memcpy(out + out_len, glyph->bytes, sizeof(glyph->bytes));
+	out_len += glyph->len;
+	term_x++;
+}
+
+static void out_flush(void)
+{
+	unsigned long written = 0;
+
+	screen_stats.bytes_out += out_len;
+
+	while (written < out_len) {
+		ssize_t ret = write(out_fd, out + written, out_len - written);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		written += ret;
+	}
+	out_len = 0;
+}
+
+/*
+ *	Moving the cursor costs at least six bytes so it's cheaper to
+ *	just rewrite a few unchanged cells that have the same attribute.
+ */
+#define MAX_REWRITE_GAP 4
+
+static bool can_rewrite_gap(const unsigned int * row, unsigned long x)
+{
+	unsigned long i;
+
+	if (term_x >= x || x - term_x > MAX_REWRITE_GAP)
+		return false;
+
+	for (i = term_x; i < x; i++) {
+		if (((row[i] & 0xFF00) >> 8) != term_attr)
+			return false;
+	}
+	return true;
+}
+
+static void compose_row(unsigned long y, bool * changed)
+{
+	unsigned int * b = back + y * cols;
+	unsigned int * f = front + y * cols;
+	unsigned long x;
+
+	for (x = 0; x < cols; x++) {
+		if (b[x] == f[x])
+			continue;
+
+		if (!*changed) {
+			/* Hide cursor while drawing.  */
+			OUT_LITERAL("\x1B[?25l");
+			*changed = true;
+		}
+
+		if (term_y == y && can_rewrite_gap(b, x)) {
+			while (term_x < x)
+				out_cell(b[term_x]);
+		} else if (term_y != y || term_x != x)
+			out_move(y, x);
+
+		out_cell(b[x]);
+		f[x] = b[x];
+	}
+
+	/* The terminal might have wrapped, don't trust the position.  */
+	if (term_x >= cols)
+		term_y = term_x = UNKNOWN_POS;
+}
+
+/*
+ *	Backend operations
+ */
+
+static void invalidate_front(void)
+{
+	unsigned long i;
+
+	for (i = 0; i < rows * cols; i++)
+		front[i] = INVALID_CELL;
+
+	term_y = term_x = UNKNOWN_POS;
+	term_attr = -1;
+}
+
+static void get_term_size(void)
+{
+	struct winsize ws;
+
+	if (ioctl(out_fd, TIOCGWINSZ, &ws) == 0 && ws.ws_row && ws.ws_col) {
+		rows = ws.ws_row;
+		cols = ws.ws_col;
+	} else {
+		rows = 24;
+		cols = 80;
+	}
+}
+
+static bool headless = false;
+
+static void alloc_buffers(void)
+{
+	front = malloc(rows * cols * sizeof(unsigned int));
+	back  = malloc(rows * cols * sizeof(unsigned int));
+	out   = malloc(rows * cols * MAX_CELL_OUTPUT + MAX_FRAME_OVERHEAD);
+	if (!front || !back || !out)
+		error("Could not allocate memory for screen.");
+
+	unsigned long i;
+	for (i = 0; i < rows * cols; i++)
+		back[i] = CHAR_ATTR_TO_INT(COLOR_ATTR(7, 0), ' ');
+	invalidate_front();
+}
+
+static bool raw_init(struct screen * scr)
+{
+	struct termios raw;
+
+	if (screen_get_headless(&out_fd, &rows, &cols)) {
+		headless = true;
+		alloc_buffers();
+		scr->height = rows;
+		scr->width  = cols;
+		return true;
+	}
+
+	if (!isatty(in_fd) || !isatty(out_fd))
+		return false;
+
+	if (tcgetattr(in_fd, &saved_termios) < 0)
+		return false;
+
+	raw = saved_termios;
+	raw.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+	raw.c_oflag &= ~(OPOST);
+	raw.c_cflag |= CS8;
+	raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+	raw.c_cc[VMIN]  = 1;
+	raw.c_cc[VTIME] = 0;
+
+	if (tcsetattr(in_fd, TCSAFLUSH, &raw) < 0)
+		return false;
+
+	get_term_size();
+	alloc_buffers();
+
+	/* Switch to alternate screen and clear it.  */
+	OUT_LITERAL("\x1B[?1049h\x1B[H\x1B[2J");
+	out_flush();
+
+	scr->height = rows;
+	scr->width  = cols;
+
+	return true;
+}
+
+static void raw_restore(void)
+{
+	static const char reset[] = "\x1B[0m\x1B[?25h\x1B[?1049l";
+
+	if (headless)
+		return;
+
+	if (write(out_fd, reset, sizeof(reset) - 1) < 0)
+		;
+	tcsetattr(in_fd, TCSAFLUSH, &saved_termios);
+}
+
+static void raw_release(void)
+{
+	raw_restore();
+
+	free(front);
+	free(back);
+	free(out);
+	front = back = NULL;
+	out = NULL;
+}
+
+/* Headless, the new size comes from screen_set_headless().  */
+static void raw_resize(struct screen * scr)
+{
+	if (headless)
+		screen_get_headless(&out_fd, &rows, &cols);
+	else
+		get_term_size();
+
+	free(front);
+	free(back);
+	free(out);
+	alloc_buffers();
+
+	/* Whatever the terminal did to the old contents, start from a
+	   clear screen.  */
+	OUT_LITERAL("\x1B[H\x1B[2J");
+	out_flush();
+
+	scr->height = rows;
+	scr->width  = cols;
+}
+
+static void raw_draw_cells(unsigned long y, unsigned long x,
+			   const unsigned int * cells, unsigned long len)
+{
+	if (y >= rows || x >= cols)
+		return;
+
+	if (x + len > cols)
+		len = cols - x;
+
+	memcpy(back + y * cols + x, cells, len * sizeof(unsigned int));
+}
+
+static void raw_move(unsigned long y, unsigned long x)
+{
+	cursor_y = y;
+	cursor_x = x;
+}
+
+static void raw_refresh(void)
+{
+	bool changed = false;
+	unsigned long y;
+
+	for (y = 0; y < rows; y++)
+		compose_row(y, &changed);
+
+	if (changed || term_y != cursor_y || term_x != cursor_x) {
+		out_move(cursor_y, cursor_x);
+		if (changed)
+			OUT_LITERAL("\x1B[?25h");
+	}
+	out_flush();
+}
+
+static void raw_redraw(void)
+{
+	invalidate_front();
+}
+
+/*
+ *	Keyboard input
+ */
+
+/* How long to wait for the rest of an escape sequence.  */
+#define ESC_DELAY_MS 25
+
+#define READ_TIMEOUT -1
+#define READ_ERROR   -2
+
+static unsigned char in_buf[64];
+static int in_len = 0;
+static int in_pos = 0;
+
+static int pending_key = 0;
+
+static bool no_delay = false;
+
+static int read_byte(int timeout_ms)
+{
+	if (in_pos < in_len)
+		return in_buf[in_pos++];
+
+	for (;;) {
+		struct pollfd pfd = { .fd = in_fd, .events = POLLIN };
+
+		int ret = poll(&pfd, 1, timeout_ms);
+		if (ret < 0) {
+			if (errno != EINTR)
+				return READ_ERROR;
+			continue;
+		}
+		if (ret == 0)
+			return READ_TIMEOUT;
+
+		ssize_t len = read(in_fd, in_buf, sizeof(in_buf));
+		if (len < 0 && errno == EINTR)
+			continue;
+		if (len <= 0)
+			return READ_ERROR;
+
+		in_len = len;
+		in_pos = 0;
+		return in_buf[in_pos++];
+	}
+}
+
+static int tilde_key(int param)
+{
+	switch (param) {
+		case 1:
+		case 7:
+			return KEY_HOME;
+		case 2:
+			return KEY_IC;
+		case 3:
+			return KEY_DC;
+		case 4:
+		case 8:
+			return KEY_END;
+		case 5:
+			return KEY_PPAGE;
+		case 6:
+			return KEY_NPAGE;
+	}
+	if (param >= 11 && param <= 15)
+		return KEY_F(param - 10);
+	if (param >= 17 && param <= 21)
+		return KEY_F(param - 11);
+	if (param >= 23 && param <= 24)
+		return KEY_F(param - 12);
+	return 0;
+}
+
+#define MAX_SEQ_PARAMS 4
+
+/* Decode the rest of a CSI (ESC [) or SS3 (ESC O) sequence.  Returns
+   zero for sequences we don't know about.  */
+static int decode_seq(int intro)
+{
+	int params[MAX_SEQ_PARAMS] = { 0 };
+	int nr_params = 0;
+	int ch;
+
+	for (;;) {
+		ch = read_byte(ESC_DELAY_MS);
+		if (ch < 0)
+			return 0;
+
+		if (ch >= '0' && ch <= '9')
+			params[nr_params] = params[nr_params] * 10 + ch - '0';
+		else if (ch == ';') {
+			if (nr_params < MAX_SEQ_PARAMS - 1)
+				nr_params++;
+		} else if (ch == '[' && intro == '[') {
+			/* Linux console function keys: ESC [ [ A..E  */
+			ch = read_byte(ESC_DELAY_MS);
+			if (ch >= 'A' && ch <= 'E')
+				return KEY_F(ch - 'A' + 1);
+			return 0;
+		} else
+			break;
+	}
+
+	int key;
+	switch (ch) {
+		case 'A': key = KEY_UP;    break;
+		case 'B': key = KEY_DOWN;  break;
+		case 'C': key = KEY_RIGHT; break;
+		case 'D': key = KEY_LEFT;  break;
+		case 'H': key = KEY_HOME;  break;
+		case 'F': key = KEY_END;   break;
+		case 'P': key = KEY_F(1);  break;
+		case 'Q': key = KEY_F(2);  break;
+		case 'R': key = KEY_F(3);  break;
+		case 'S': key = KEY_F(4);  break;
+		case 'Z': key = KEY_BTAB;  break;
+		case '~': key = tilde_key(params[0]); break;
+		default:  key = 0; break;
+	}
+
+	/* Modifier parameter has Alt in bit 1, report it as META.  */
+	if (key && nr_params > 0 && ((params[nr_params] - 1) & 0x02)) {
+		pending_key = key;
+		return 27;
+	}
+	return key;
+}
+
+static int raw_get_key(void)
+{
+	int ch;
+
+	if (pending_key) {
+		ch = pending_key;
+		pending_key = 0;
+		return ch;
+	}
+
+	if (headless)
+		return ERR;
+
+	for (;;) {
+		ch = read_byte(no_delay ? 0 : -1);
+		if (ch < 0)
+			return ERR;
+
+		if (ch == 27) {
+			int next = read_byte(ESC_DELAY_MS);
+			if (next == '[' || next == 'O') {
+				int key = decode_seq(next);
+				if (key == 0)
+					continue;
+				return key;
+			}
+			/* Plain ESC or META prefix; leave the next
+			   character for the following call.  */
+			if (next >= 0)
+				in_pos--;
+			return 27;
+		}
+
+		if (ch == 127 || ch == 8)
+			return KEY_BACKSPACE;
+
+		return ch;
+	}
+}
+
+static void raw_nodelay(bool on)
+{
+	no_delay = on;
+}
+
+/*
+ *	Text input
+ */
+
+#define PROMPT_FIELD_LEN 25
+
+#define PROMPT_KEY_ENTER 13
+#define PROMPT_KEY_ESC   27
+
+static void draw_text(unsigned long y, unsigned long x, int attr,
+		      const char * text, unsigned long len)
+{
+	unsigned int cells[len];
+	unsigned long i;
+
+	for (i = 0; i < len; i++)
+		cells[i] = CHAR_ATTR_TO_INT(attr, text[i]);
+	raw_draw_cells(y, x, cells, len);
+}
+
+static char * raw_prompt(struct screen * scr, const char * text)
+{
+	char field[PROMPT_FIELD_LEN + 1];
+	unsigned long len = 0;
+
+	unsigned long text_len = strlen(text);
+	unsigned long y = scr->height / 2;
+	unsigned long x = 0;
+
+	if (scr->width > PROMPT_FIELD_LEN + text_len)
+		x = (scr->width - PROMPT_FIELD_LEN - text_len) / 2;
+
+	static const char help[] =
+		"Press Enter to accept; double ESC to exit screen.";
+	draw_text(1, 1, COLOR_ATTR(7, 0), help, sizeof(help) - 1);
+	draw_text(y, x, COLOR_ATTR(7, 0), text, text_len);
+	x += text_len + 1;
+
+	for (;;) {
+		memset(field + len, ' ', PROMPT_FIELD_LEN - len);
+		draw_text(y, x, COLOR_ATTR(0, 7), field, PROMPT_FIELD_LEN);
+		raw_move(y, x + (len < PROMPT_FIELD_LEN ? len : len - 1));
+		raw_refresh();
+
+		/* Keys come decoded, so double ESC is META-ESC.  */
+		int ch = input_get_key();
+		if (ch == ERR || ch == KEY_META(PROMPT_KEY_ESC)) {
+			len = 0;
+			break;
+		}
+		if (ch == PROMPT_KEY_ENTER)
+			break;
+
+		if (ch == KEY_BACKSPACE) {
+			if (len > 0)
+				len--;
+		} else if (ch >= 0x20 && ch < 0x7F && len < PROMPT_FIELD_LEN)
+			field[len++] = ch;
+	}
+
+	/* Trim trailing whitespace.  */
+	while (len > 0 && field[len - 1] == ' ')
+		len--;
+
+	if (len == 0)
+		return NULL;
+
+	char * ret = malloc(len + 1);
+	if (!ret)
+		error("Out of memory.");
+	memcpy(ret, field, len);
+	ret[len] = 0;
+
+	return ret;
+}
+
+const struct screen_backend screen_raw_backend = {
+	.name           = "raw",
+	.init           = raw_init,
+	.release        = raw_release,
+	.resize         = raw_resize,
+	.draw_cells     = raw_draw_cells,
+	.move           = raw_move,
+	.refresh        = raw_refresh,
+	.redraw         = raw_redraw,
+	.threaded_input = true,
+	.get_key        = raw_get_key,
+	.nodelay        = raw_nodelay,
+	.prompt         = raw_prompt,
+	.restore        = raw_restore
+};
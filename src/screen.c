@@ -17,76 +17,326 @@
  */
 
 #include <assert.h>
-#include <curses.h>
-#include <ctype.h>
-#include <form.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "colors.h"
+#include "cp437.h"
 #include "editor-context.h"
 #include "edit-buffer.h"
 #include "error.h"
 #include "screen.h"
 
-static void init_curses(void)
+static const struct screen_backend * backend;
+
+static const struct screen_backend * backends[] = {
+	&screen_raw_backend,
+	&screen_curses_backend,
+	&screen_mem_backend,
+	NULL
+};
+
+struct screen_stats screen_stats;
+
+static bool headless = false;
+static int headless_fd;
+static unsigned long headless_height;
+static unsigned long headless_width;
+
+void screen_set_headless(int fd, unsigned long height, unsigned long width)
 {
-	savetty();
+	headless = true;
+	headless_fd = fd;
+	headless_height = height;
+	headless_width = width;
+}
 
-	if (initscr() == NULL)
-		error("Could not initialize screen.");
+bool screen_get_headless(int * fd, unsigned long * height,
+			 unsigned long * width)
+{
+	if (!headless)
+		return false;
 
-	nonl();
-	cbreak();
-	noecho();
-	keypad(stdscr, TRUE);
+	*fd = headless_fd;
+	*height = headless_height;
+	*width = headless_width;
+	return true;
+}
 
-	if (has_colors() == FALSE) {
-		error("Your terminal doesn't support colors.");
+const struct screen_backend * screen_backend_lookup(const char * name)
+{
+	int i;
+
+	for (i = 0; backends[i] != NULL; i++) {
+		if (strcmp(backends[i]->name, name) == 0)
+			return backends[i];
 	}
-	start_color();
+	return NULL;
 }
 
-static void release_curses(void)
+static bool char_set_forced = false;
+
+/* One row worth of cells for composing the status bar.  */
+static unsigned int * status_cells;
+
+/*
+ *	Status bar
+ *
+ *	The status bar is split into segments that are formatted into a
+ *	fixed buffer and drawn only when the state they show changes.
+ */
+#define STATUS_TEXT_LEN 64
+
+struct status_segment {
+	unsigned long x;
+	unsigned long len;
+	bool valid;
+	unsigned long state[2];
+	char text[STATUS_TEXT_LEN];
+};
+
+enum {
+	STATUS_POSITION,
+	STATUS_COLOR,
+	STATUS_MODIFIED,
+	STATUS_MACRO,
+	STATUS_SAVE,
+	STATUS_FILENAME,
+	STATUS_HIGHASCII_SET,
+	NR_STATUS_SEGMENTS
+};
+
+static struct status_segment status_segments[NR_STATUS_SEGMENTS];
+static bool status_cleared;
+
+#define HIGHASCII_SET_STATUS_LEN 42
+
+static void status_layout(struct screen * scr)
 {
-	resetty();
-	endwin();
+	static const struct {
+		unsigned long x;
+		unsigned long len;
+	} layout[] = {
+		[STATUS_POSITION]	= {  1, 11 },
+		[STATUS_COLOR]		= { 13,  5 },
+		[STATUS_MODIFIED]	= { 19,  1 },
+		[STATUS_MACRO]		= { 21,  3 },
+		[STATUS_SAVE]		= { 25, 11 },
+		[STATUS_FILENAME]	= { 37,  0 },
+		[STATUS_HIGHASCII_SET]	= {  0, HIGHASCII_SET_STATUS_LEN - 1 }
+	};
+	int i;
+
+	for (i = 0; i < NR_STATUS_SEGMENTS; i++) {
+		status_segments[i].x = layout[i].x;
+		status_segments[i].len = layout[i].len;
+		status_segments[i].valid = false;
+	}
+
+	struct status_segment * set = &status_segments[STATUS_HIGHASCII_SET];
+	struct status_segment * name = &status_segments[STATUS_FILENAME];
+
+	if (scr->width >= HIGHASCII_SET_STATUS_LEN) {
+		set->x = scr->width - HIGHASCII_SET_STATUS_LEN;
+		if (set->x > name->x + 1)
+			name->len = set->x - name->x - 1;
+	} else
+		set->len = 0;
+
+	if (name->len > STATUS_TEXT_LEN - 1)
+		name->len = STATUS_TEXT_LEN - 1;
+
+	/* Drop whatever doesn't fit.  */
+	for (i = 0; i < NR_STATUS_SEGMENTS; i++) {
+		struct status_segment * seg = &status_segments[i];
+
+		if (seg->x >= scr->width)
+			seg->len = 0;
+		else if (seg->x + seg->len > scr->width)
+			seg->len = scr->width - seg->x;
+	}
+	status_cleared = false;
 }
 
-static bool char_set_forced = false;
+static bool status_changed(struct status_segment * seg,
+			   unsigned long a, unsigned long b)
+{
+	if (seg->len == 0)
+		return false;
+
+	if (seg->valid && seg->state[0] == a && seg->state[1] == b)
+		return false;
+
+	seg->valid = true;
+	seg->state[0] = a;
+	seg->state[1] = b;
+	return true;
+}
+
+/* Draw the segment text padded with blanks to the segment length.  */
+static void status_draw(struct screen * scr, struct status_segment * seg,
+			int attribute)
+{
+	unsigned long i;
+	const char * str = seg->text;
 
-struct screen * screen_init(bool force_ibm_cp437, unsigned long max_width)
+	for (i = 0; i < seg->len; i++) {
+		int ch = *str ? *str++ : ' ';
+		status_cells[i] = CHAR_ATTR_TO_INT(attribute, ch);
+	}
+	backend->draw_cells(scr->height, seg->x, status_cells, seg->len);
+	screen_stats.draw_calls++;
+	screen_stats.cells_drawn += seg->len;
+}
+
+#define RED_ON_BLACK COLOR_ATTR(1, 0)
+#define GREY_ON_BLACK COLOR_ATTR(7, 0)
+
+void screen_print_status(struct edit_buffer *buf, struct screen *scr,
+			 struct editor_context *ctx, char * highascii_set)
 {
-	init_curses();
-	init_color_pairs();
+	struct status_segment * seg;
+
+	/*
+	 * Last line on the screen is the status bar
+	 */
+	if (!status_cleared) {
+		unsigned long x;
+
+		for (x = 0; x < scr->width; x++)
+			status_cells[x] = CHAR_ATTR_TO_INT(GREY_ON_BLACK, ' ');
+		backend->draw_cells(scr->height, 0, status_cells, scr->width);
+		screen_stats.draw_calls++;
+		screen_stats.cells_drawn += scr->width;
+		status_cleared = true;
+	}
+
+	unsigned long pos_x = scr->cursor_x + buf->start_x + 1;
+	unsigned long pos_y = scr->cursor_y + buf->start_y + 1;
+
+	seg = &status_segments[STATUS_POSITION];
+	if (status_changed(seg, pos_x, pos_y)) {
+		snprintf(seg->text, STATUS_TEXT_LEN, "(%2lu, %2lu)",
+			 pos_x, pos_y);
+		status_draw(scr, seg, RED_ON_BLACK);
+	}
+
+	seg = &status_segments[STATUS_COLOR];
+	if (status_changed(seg, ctx->fg_color, ctx->bg_color)) {
+		strcpy(seg->text, "Color");
+		status_draw(scr, seg, COLOR_ATTR(ctx->fg_color, ctx->bg_color));
+	}
+
+	seg = &status_segments[STATUS_MODIFIED];
+	if (status_changed(seg, ctx->modified, 0)) {
+		strcpy(seg->text, ctx->modified ? "*" : "");
+		status_draw(scr, seg, RED_ON_BLACK);
+	}
+
+	seg = &status_segments[STATUS_MACRO];
+	if (status_changed(seg, ctx->recording_macro, 0)) {
+		strcpy(seg->text, ctx->recording_macro ? "REC" : "");
+		status_draw(scr, seg, RED_ON_BLACK);
+	}
 
+	/* Shared with the outcome of a find while not saving.  */
+	seg = &status_segments[STATUS_SAVE];
+	if (status_changed(seg, ctx->save_progress,
+			   ctx->save_failed | ctx->search_result << 1)) {
+		if (ctx->save_progress >= 0)
+			snprintf(seg->text, STATUS_TEXT_LEN, "SAVING %3i%%",
+				 ctx->save_progress);
+		else if (ctx->save_failed)
+			strcpy(seg->text, "SAVE FAILED");
+		else if (ctx->search_result == SEARCH_NOT_FOUND)
+			strcpy(seg->text, "NOT FOUND");
+		else if (ctx->search_result == SEARCH_BAD_PATTERN)
+			strcpy(seg->text, "BAD PATTERN");
+		else
+			strcpy(seg->text, "");
+		status_draw(scr, seg, RED_ON_BLACK);
+	}
+
+	/* File name is compared as text since it may be changed in place.  */
+	seg = &status_segments[STATUS_FILENAME];
+	const char * filename = ctx->filename ? ctx->filename : "";
+	if (seg->len > 0 && (!seg->valid
+			     || strncmp(seg->text, filename, seg->len) != 0)) {
+		seg->valid = true;
+		snprintf(seg->text, seg->len + 1, "%s", filename);
+		status_draw(scr, seg, GREY_ON_BLACK);
+	}
+
+	seg = &status_segments[STATUS_HIGHASCII_SET];
+	if (status_changed(seg, (unsigned long) highascii_set, 0)) {
+		int i, len = 0;
+
+		for (i = 0; i < 10; i++)
+			len += snprintf(seg->text + len, STATUS_TEXT_LEN - len,
+					" %i=%c", i + 1, highascii_set[i]);
+		status_draw(scr, seg, GREY_ON_BLACK);
+	}
+}
+
+static unsigned long screen_max_width;
+
+/* Fit the screen in the backend's full size and lay out the status bar.  */
+static void screen_fit(struct screen * scr)
+{
+	if (scr->width > screen_max_width)
+		scr->width = screen_max_width;
+
+	/* Leave a free line for the status bar.  */
+	if (scr->height > 1)
+		scr->height--;
+
+	free(status_cells);
+	status_cells = malloc(scr->width * sizeof(unsigned int));
+	if (!status_cells)
+		error("Could not allocate memory for screen.");
+	status_layout(scr);
+}
+
+struct screen * screen_init(const struct screen_backend * requested,
+			    enum screen_charset charset, unsigned long max_width)
+{
 	struct screen * ret = malloc(sizeof(struct screen));
 	if (!ret)
 		error("Could not allocate memory for screen.");
 
-	getmaxyx(stdscr, ret->height, ret->width);
-	if (ret->height == -1 || ret->width == -1)
-		error("Could not get screen dimensions from curses.");
+	ret->cursor_x = 0;
+	ret->cursor_y = 0;
 
-	if (ret->width > max_width)
-		ret->width = max_width;
+	cp437_init(charset == SCREEN_CHARSET_UTF8);
 
-	/* Leave a free line for the status bar.  */
-	ret->height--;
+	/* The curses backend is the fallback for everything else.  */
+	backend = requested;
+	if (!backend->init(ret)) {
+		backend = &screen_curses_backend;
+		backend->init(ret);
+	}
+
+	screen_max_width = max_width;
+	screen_fit(ret);
 
-	if (force_ibm_cp437) {
+	if (charset == SCREEN_CHARSET_FORCE_CP437) {
 		char_set_forced = true;
 		/* Set IBM CP437 character set.  Taken from Duh DRAW; seems
 		   to work on regular Linux console.  */
 		printf("\e(U");
+		fflush(stdout);
 	}
 	return ret;
 }
 
 void screen_release(struct screen * screen)
 {
+	free(status_cells);
+	status_cells = NULL;
 	free(screen);
-	release_curses();
+	backend->release();
+	backend = NULL;
 
 	if (char_set_forced) {
 		/* Set "UNIX" character set (whatever that means).  This is
@@ -95,24 +345,17 @@ void screen_release(struct screen * screen)
 	}
 }
 
-static void screen_set_unset_attr(int attribute, bool on)
+/* Cursor and viewport are left for the editor to clamp.  */
+void screen_resize(struct screen * scr)
 {
-	int fg_color = (attribute & 0x0F);
-	int bg_color = (attribute & 0xF0) >> 4;
-
-	if (fg_color > 7) {
-		if (on)
-			attron(A_BOLD);
-		else
-			attroff(A_BOLD);
-		fg_color -= 8;
-	}
+	backend->resize(scr);
+	screen_fit(scr);
+}
 
-	int attr = COLOR_PAIR(attr_to_color_pair(fg_color, bg_color));
-	if (on)
-		attron(attr);
-	else
-		attroff(attr);
+void screen_restore_terminal(void)
+{
+	if (backend)
+		backend->restore();
 }
 
 void screen_draw_edit_buffer(struct screen * scr, struct edit_buffer *buf)
@@ -122,143 +365,90 @@ void screen_draw_edit_buffer(struct screen * scr, struct edit_buffer *buf)
 	assert(buf->start_x >= 0);
 	assert(buf->start_y >= 0);
 
-	int x, y;
+	unsigned long y;
 
 	for (y = 0; y < scr->height; y++) {
-		for (x = 0; x < scr->width; x++) {
-			int attribute = (edit_buffer_get(buf,
-							 buf->start_x + x,
-							 buf->start_y +
-							 y) & 0xFF00) >> 8;
-			int character = edit_buffer_get(buf,
-							buf->start_x + x,
-							buf->start_y +
-							y) & 0xFF;
-			screen_set_unset_attr(attribute, true);
-			mvprintw(y, x, "%c", character);
-			screen_set_unset_attr(attribute, false);
-		}
+		unsigned int * row = &buf->buffer[(buf->start_y + y) * buf->width
+						   + buf->start_x];
+		backend->draw_cells(y, 0, row, scr->width);
 	}
+	screen_stats.draw_calls += scr->height;
+	screen_stats.cells_drawn += scr->height * scr->width;
 }
 
-void screen_print_status(struct edit_buffer *buf, struct screen *scr,
-			 struct editor_context *ctx, char * highascii_set)
+/* Text padded with blanks to len, drawn over whatever is on the screen
+   until the next frame.  */
+void screen_draw_text(struct screen * scr, unsigned long y, unsigned long x,
+		      int attribute, const char * text, unsigned long len)
 {
-	/*
-	 * Last line on the screen is the status bar
-	 */
-	move(scr->height, 0);
-	clrtoeol();
-
-#define RED_ON_BLACK COLOR_ATTR(1, 0)
-	screen_set_unset_attr(RED_ON_BLACK, true);
-	mvprintw(scr->height, 1, "(%2i, %2i)",
-		 scr->cursor_x + buf->start_x + 1,
-		 scr->cursor_y + buf->start_y + 1);
-	screen_set_unset_attr(RED_ON_BLACK, false);
+	unsigned long i;
 
-	move(scr->height, 13);
-	screen_set_unset_attr(COLOR_ATTR(ctx->fg_color, ctx->bg_color), true);
-	printw("Color");
-	screen_set_unset_attr(COLOR_ATTR(ctx->fg_color, ctx->bg_color), false);
+	if (x >= scr->width)
+		return;
+	if (x + len > scr->width)
+		len = scr->width - x;
 
-#define HIGHASCII_SET_STATUS_LEN 42
-	move(scr->height, scr->width - HIGHASCII_SET_STATUS_LEN);
-
-#define GREY_ON_BLACK COLOR_ATTR(7, 0)
-	screen_set_unset_attr(GREY_ON_BLACK, true);
+	for (i = 0; i < len; i++) {
+		int ch = *text ? *text++ : ' ';
+		status_cells[i] = CHAR_ATTR_TO_INT(attribute, ch);
+	}
+	backend->draw_cells(y, x, status_cells, len);
+	screen_stats.draw_calls++;
+	screen_stats.cells_drawn += len;
+}
 
-	int i;
-	for (i = 0; i < 10; i++)
-		printw(" %i=%c", i + 1, highascii_set[i]);
-	screen_set_unset_attr(GREY_ON_BLACK, false);
+/* Cells drawn over the screen like text.  */
+void screen_draw_cells(struct screen * scr, unsigned long y, unsigned long x,
+		       const unsigned int * cells, unsigned long len)
+{
+	if (x >= scr->width)
+		return;
+	if (x + len > scr->width)
+		len = scr->width - x;
+
+	backend->draw_cells(y, x, cells, len);
+	screen_stats.draw_calls++;
+	screen_stats.cells_drawn += len;
 }
 
 void screen_move(unsigned long cursor_y, unsigned long cursor_x)
 {
-	move(cursor_y, cursor_x);
+	backend->move(cursor_y, cursor_x);
 }
 
-void screen_redraw(void)
+void screen_refresh(void)
 {
-	redrawwin(stdscr);
+	backend->refresh();
+	screen_stats.refreshes++;
 }
 
-static char * trim_trailing(const char * str)
+void screen_redraw(void)
 {
-	unsigned long len;
-	for (len = strlen(str); len > 0 && isspace(str[len - 1]); len--)
-		;;
-	
-	char * ret = malloc(len + 1);
-	strncpy(ret, str, len);
-	ret[len] = 0;
-
-	return ret;
+	backend->redraw();
 }
 
-char * screen_save_file_dialog(struct screen * scr)
+int screen_get_key(void)
 {
-	assume_default_colors(7, COLOR_BLACK);
-
-#define SAVE_TEXT "Save to file:"
-#define SAVE_TEXT_LEN strlen(SAVE_TEXT)
-#define SAVE_FIELD_LEN 25
-
-#define CENTER_START ((scr->width - SAVE_FIELD_LEN - SAVE_TEXT_LEN) / 2)
-
-	FIELD * fields[2];
-
-	fields[0] = new_field(1, SAVE_FIELD_LEN, scr->height / 2,
-			      CENTER_START + SAVE_TEXT_LEN + 1, 0, 0);
-	fields[1] = NULL;
-
-	set_field_back(fields[0], A_UNDERLINE);
-
-	FORM * form = new_form(fields);
-	post_form(form);
-	refresh();
-
-	mvprintw(scr->height / 2, CENTER_START, SAVE_TEXT);
-	mvprintw(1, 1, "Press Enter to save; double ESC to exit screen.");
-
-#define FORM_KEY_ENTER 13
-#define FORM_KEY_ESC   27
-#define FORM_KEY_BACKSPACE 127
-
-	bool quit = false;
-	while (!quit) {
-		int ch = getch();
-		switch (ch) {
-			case FORM_KEY_ENTER:
-				form_driver(form, REQ_END_FIELD);
-				quit = true;
-				break;
-			case FORM_KEY_ESC:
-				/* Don't end field so we get an empty
-				   filename.  */
-				quit = true;
-				break;
-			case FORM_KEY_BACKSPACE:
-				form_driver(form, REQ_DEL_PREV);
-				break;
-			default:
-				form_driver(form, ch);
-				break;
-		}
-	}
+	return backend->get_key();
+}
 
-	char * ret = trim_trailing(field_buffer(fields[0], 0));
-	if (strlen(ret) == 0) {
-		free(ret);
-		ret = NULL;
-	}
+void screen_nodelay(bool nodelay)
+{
+	backend->nodelay(nodelay);
+}
 
-	unpost_form(form);
-	free_form(form);
-	free_field(fields[0]);
+bool screen_threaded_input(void)
+{
+	return backend->threaded_input;
+}
 
-	assume_default_colors(0, COLOR_BLACK);
+/* Single line text input.  Returns NULL if cancelled or empty.  */
+char * screen_prompt(struct screen * scr, const char * text)
+{
+	return backend->prompt(scr, text);
+}
 
-	return ret;
+char * screen_save_file_dialog(struct screen * scr)
+{
+	return screen_prompt(scr, "Save to file:");
 }
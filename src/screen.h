@@ -21,6 +21,7 @@
 
 #include <stdbool.h>
 
+struct edit_buffer;
 struct editor_context;
 
 /* Visible screen information.  */
@@ -31,13 +32,98 @@ struct screen {
 	unsigned long width;
 };
 
-struct screen * screen_init(bool, unsigned long);
+/*
+ *	A screen backend does the actual terminal I/O.  Everything is
+ *	drawn as rows of edit buffer cells (see CHAR_ATTR_TO_INT) and
+ *	becomes visible on the next refresh.
+ */
+struct screen_backend {
+	const char * name;
+
+	/* Set up the terminal and store its full size in the screen.
+	   Returns false if the backend cannot be used here.  */
+	bool (*init)(struct screen *);
+	void (*release)(void);
+
+	/* Store the full size again after the terminal was resized.  */
+	void (*resize)(struct screen *);
+
+	void (*draw_cells)(unsigned long y, unsigned long x,
+			   const unsigned int * cells, unsigned long len);
+	void (*move)(unsigned long y, unsigned long x);
+	void (*refresh)(void);
+	void (*redraw)(void);
+
+	/* Returns the next key as a curses KEY_xxx or character code.  */
+	int (*get_key)(void);
+
+	/* In nodelay mode get_key returns ERR if no key is waiting.  */
+	void (*nodelay)(bool);
+
+	/* get_key may be called on another thread while drawing.  */
+	bool threaded_input;
+
+	/* Single line text input.  Returns NULL if cancelled.  */
+	char * (*prompt)(struct screen *, const char *);
+
+	/* Put the terminal back to normal in a hurry (see error()).  */
+	void (*restore)(void);
+};
+
+extern const struct screen_backend screen_curses_backend;
+extern const struct screen_backend screen_raw_backend;
+extern const struct screen_backend screen_mem_backend;
+
+/* Output statistics for benchmarking.  */
+struct screen_stats {
+	unsigned long draw_calls;
+	unsigned long cells_drawn;
+	unsigned long refreshes;
+	unsigned long bytes_out;
+};
+
+extern struct screen_stats screen_stats;
+
+/*
+ *	Headless operation: the memory backend and the raw backend draw a
+ *	screen of the given size without a terminal.  The raw backend
+ *	writes its output to the given file descriptor.
+ */
+void screen_set_headless(int, unsigned long, unsigned long);
+bool screen_get_headless(int *, unsigned long *, unsigned long *);
+
+/* Memory backend framebuffer and scripted input.  */
+unsigned int screen_mem_get_cell(unsigned long, unsigned long);
+void screen_mem_feed_keys(const int *, unsigned long);
+
+const struct screen_backend * screen_backend_lookup(const char *);
+
+/* How CP437 characters are sent to the terminal.  */
+enum screen_charset {
+	SCREEN_CHARSET_NATIVE,		/* as is */
+	SCREEN_CHARSET_FORCE_CP437,	/* as is, switch Linux console to CP437 */
+	SCREEN_CHARSET_UTF8		/* translated to UTF-8 */
+};
+
+struct screen * screen_init(const struct screen_backend *,
+			    enum screen_charset, unsigned long);
 void screen_release(struct screen * screen);
+void screen_resize(struct screen *);
+void screen_restore_terminal(void);
 void screen_draw_edit_buffer(struct screen *, struct edit_buffer *);
 void screen_print_status(struct edit_buffer *, struct screen *,
 			 struct editor_context *, char *);
+void screen_draw_text(struct screen *, unsigned long, unsigned long, int,
+		      const char *, unsigned long);
+void screen_draw_cells(struct screen *, unsigned long, unsigned long,
+		       const unsigned int *, unsigned long);
 void screen_move(unsigned long, unsigned long);
+void screen_refresh(void);
 void screen_redraw(void);
+int screen_get_key(void);
+void screen_nodelay(bool);
+bool screen_threaded_input(void);
+char * screen_prompt(struct screen *, const char *);
 char * screen_save_file_dialog(struct screen *);
 
 #endif
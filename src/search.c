@@ -0,0 +1,578 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "edit-buffer.h"
+#include "error.h"
+#include "search.h"
+
+/*
+ *	Patterns
+ *
+ *	A query is glyphs to find, with a few escapes:
+ *
+ *		\n	start the next row of a rectangular pattern
+ *		\?	any cell
+ *		\xHH	the glyph with CP437 code HH
+ *		\fH	following glyphs in foreground color H (hex)
+ *		\bH	following glyphs on background color H
+ *		\f-	following glyphs in any foreground color (\b- too)
+ *		\\	a backslash
+ *
+ *	Rows shorter than the longest one are padded with any cells.
+ */
+
+static int hex_digit(char ch)
+{
+	if (ch >= '0' && ch <= '9')
+		return ch - '0';
+	if (ch >= 'a' && ch <= 'f')
+		return ch - 'a' + 10;
+	if (ch >= 'A' && ch <= 'F')
+		return ch - 'A' + 10;
+	return -1;
+}
+
+static struct search_pattern * pattern_alloc(unsigned long width,
+					     unsigned long height)
+{
+	struct search_pattern * p = malloc(sizeof(struct search_pattern));
+
+	if (!p)
+		error("Could not allocate memory for search pattern.");
+	p->width = width;
+	p->height = height;
+	p->cells = calloc(width * height, sizeof(unsigned int));
+	p->masks = calloc(width * height, sizeof(unsigned int));
+	p->anchor = 0;
+	if (!p->cells || !p->masks)
+		error("Could not allocate memory for search pattern.");
+	return p;
+}
+
+/* Anchor on the first glyph other than a blank, which is the least
+   likely to turn up everywhere, or failing that any cell that has to
+   match something.  */
+static void pick_anchor(struct search_pattern * p)
+{
+	unsigned long i, n = p->width * p->height;
+
+	for (i = 0; i < n; i++) {
+		if ((p->masks[i] & SEARCH_GLYPH)
+		    && (p->cells[i] & SEARCH_GLYPH) != ' ') {
+			p->anchor = i;
+			return;
+		}
+	}
+	for (i = 0; i < n; i++) {
+		if (p->masks[i]) {
+			p->anchor = i;
+			return;
+		}
+	}
+	p->anchor = 0;
+}
+
+/* Returns NULL if the query is empty or has a bad escape.  */
+struct search_pattern * search_compile(const char * query)
+{
+	unsigned long len = strlen(query), nr_cells = 0;
+	unsigned long width = 0, height = 1, col = 0, i;
+	struct search_pattern * p;
+	unsigned int cell_mask = SEARCH_GLYPH, attr = 0;
+	struct {
+		unsigned long x, y;
+		unsigned int cell, mask;
+	} * cells;
+	const char * s;
+
+	cells = malloc((len + 1) * sizeof(*cells));
+	if (!cells)
+		error("Could not allocate memory for search pattern.");
+
+	for (s = query; *s; s++) {
+		unsigned int glyph = (unsigned char) *s, mask = cell_mask;
+		int hi, lo;
+
+		if (*s == '\\') {
+			switch (*++s) {
+			case '\\':
+				glyph = '\\';
+				break;
+			case 'n':
+				height++;
+				col = 0;
+				continue;
+			case '?':
+				mask = 0;
+				break;
+			case 'x':
+				if ((hi = hex_digit(s[1])) < 0
+				    || (lo = hex_digit(s[2])) < 0)
+					goto bad;
+				glyph = hi << 4 | lo;
+				s += 2;
+				break;
+			case 'f':
+			case 'b':
+				if (s[1] == '-') {
+					cell_mask &= *s == 'f' ? ~SEARCH_FG
+							       : ~SEARCH_BG;
+				} else if ((hi = hex_digit(s[1])) >= 0) {
+					unsigned int bits = *s == 'f'
+							    ? SEARCH_FG
+							    : SEARCH_BG;
+
+					cell_mask |= bits;
+					attr = (attr & ~bits)
+					       | (hi << (*s == 'f' ? 8 : 12));
+				} else
+					goto bad;
+				s++;
+				continue;
+			default:
+				goto bad;
+			}
+		}
+
+		cells[nr_cells].x = col++;
+		cells[nr_cells].y = height - 1;
+		cells[nr_cells].cell = (attr | glyph) & mask;
+		cells[nr_cells].mask = mask;
+		nr_cells++;
+		if (col > width)
+			width = col;
+	}
+	if (width == 0)
+		goto bad;
+
+	p = pattern_alloc(width, height);
+	for (i = 0; i < nr_cells; i++) {
+		unsigned long k = cells[i].y * width + cells[i].x;
+
+		p->cells[k] = cells[i].cell;
+		p->masks[k] = cells[i].mask;
+	}
+	pick_anchor(p);
+	free(cells);
+	return p;
+bad:
+	free(cells);
+	return NULL;
+}
+
+static bool is_blank(unsigned int cell)
+{
+	unsigned int glyph = cell & SEARCH_GLYPH;
+
+	return (glyph == 0 || glyph == ' ' || glyph == 255)
+	       && (cell & SEARCH_BG) == 0;
+}
+
+/*
+ *	A piece of art as a pattern, cropped to what is drawn.  Blank cells
+ *	match anything so that a logo is found whatever surrounds it, and
+ *	cells showing only their background match on the color alone.
+ *	Returns NULL if nothing is drawn.
+ */
+struct search_pattern * search_from_canvas(struct edit_buffer * buf)
+{
+	unsigned long x0 = buf->width, x1 = 0, y0 = buf->max_height, y1 = 0;
+	unsigned long x, y;
+	struct search_pattern * p;
+
+	for (y = 0; y < buf->max_height; y++) {
+		for (x = 0; x < buf->width; x++) {
+			if (is_blank(buf->buffer[y * buf->width + x]))
+				continue;
+			if (x < x0)
+				x0 = x;
+			if (x + 1 > x1)
+				x1 = x + 1;
+			if (y < y0)
+				y0 = y;
+			y1 = y + 1;
+		}
+	}
+	if (x1 == 0)
+		return NULL;
+
+	p = pattern_alloc(x1 - x0, y1 - y0);
+	for (y = y0; y < y1; y++) {
+		for (x = x0; x < x1; x++) {
+			unsigned int cell = buf->buffer[y * buf->width + x];
+			unsigned int glyph = cell & SEARCH_GLYPH;
+			unsigned long k = (y - y0) * p->width + x - x0;
+
+			if (is_blank(cell))
+				p->masks[k] = 0;
+			else if (glyph == 0 || glyph == ' ' || glyph == 255)
+				p->masks[k] = SEARCH_BG;
+			else
+				p->masks[k] = SEARCH_GLYPH | SEARCH_FG
+					      | SEARCH_BG;
+			p->cells[k] = cell & p->masks[k];
+		}
+	}
+	pick_anchor(p);
+	return p;
+}
+
+void search_release(struct search_pattern * p)
+{
+	free(p->cells);
+	free(p->masks);
+	free(p);
+}
+
+/*
+ *	Scanning
+ *
+ *	The canvas is one array of cells, so the anchor is looked for a
+ *	vector at a time straight through it, 32 bytes (eight cells) with
+ *	AVX2 or 16 bytes with SSE2, and the rest of the pattern is only
+ *	compared where it turns up.
+ */
+
+/* Index of the first cell from i on that matches value under mask, or n.  */
+static unsigned long scan_anchor(const unsigned int * cells, unsigned long i,
+				 unsigned long n, unsigned int value,
+				 unsigned int mask)
+{
+#if defined(__AVX2__)
+	__m256i m = _mm256_set1_epi32(mask), v = _mm256_set1_epi32(value);
+
+	for (; i + 8 <= n; i += 8) {
+		__m256i c = _mm256_loadu_si256((const __m256i *) (cells + i));
+		unsigned int hits = _mm256_movemask_epi8(
+			_mm256_cmpeq_epi32(_mm256_and_si256(c, m), v));
+
+		if (hits)
+			return i + __builtin_ctz(hits) / 4;
+	}
+#elif defined(__SSE2__)
+	__m128i m = _mm_set1_epi32(mask), v = _mm_set1_epi32(value);
+
+	for (; i + 4 <= n; i += 4) {
+		__m128i c = _mm_loadu_si128((const __m128i *) (cells + i));
+		unsigned int hits = _mm_movemask_epi8(
+			_mm_cmpeq_epi32(_mm_and_si128(c, m), v));
+
+		if (hits)
+			return i + __builtin_ctz(hits) / 4;
+	}
+#endif
+	for (; i < n; i++) {
+		if ((cells[i] & mask) == value)
+			break;
+	}
+	return i;
+}
+
+static bool pattern_at(struct edit_buffer * buf, struct search_pattern * p,
+		       unsigned long top)
+{
+	unsigned long x, y, k = 0;
+
+	for (y = 0; y < p->height; y++) {
+		const unsigned int * row = &buf->buffer[top + y * buf->width];
+
+		for (x = 0; x < p->width; x++, k++) {
+			if ((row[x] ^ p->cells[k]) & p->masks[k])
+				return false;
+		}
+	}
+	return true;
+}
+
+/*
+ *	Find the first match at or after cell index from (y * width + x of
+ *	its top left corner) in the rows drawn so far, and store where its
+ *	top left corner is.
+ */
+bool search_find(struct edit_buffer * buf, struct search_pattern * p,
+		 unsigned long from, unsigned long * x, unsigned long * y)
+{
+	unsigned long width = buf->width;
+	unsigned long offset = p->anchor / p->width * width
+			       + p->anchor % p->width;
+	unsigned int mask = p->masks[p->anchor];
+	unsigned int value = p->cells[p->anchor];
+	unsigned long last, i, end;
+
+	if (p->width > width || p->height > buf->max_height)
+		return false;
+
+	last = (buf->max_height - p->height) * width + width - p->width;
+	if (from > last)
+		return false;
+
+	end = last + offset + 1;
+	for (i = from + offset; (i = scan_anchor(buf->buffer, i, end, value,
+						 mask)) < end; i++) {
+		unsigned long top = i - offset;
+
+		/* Anchors too near the left edge wrap to the row above
+		   and end up too near the right edge.  */
+		if (top % width + p->width <= width && pattern_at(buf, p, top)) {
+			*x = top % width;
+			*y = top / width;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ *	Grep
+ *
+ *	Searches every art file under a directory for a pattern.  Files are
+ *	parsed into a canvas per worker thread, as many workers as CPUs up
+ *	to GREP_MAX_WORKERS, and matches are printed in the order of the
+ *	files whichever finishes first.
+ */
+
+#define GREP_MAX_WORKERS 16
+
+struct grep_file {
+	char * path;
+	bool done;
+	unsigned long nr_matches;
+	unsigned long * matches;	/* x, y pairs */
+};
+
+struct grep {
+	struct search_pattern * pattern;
+	search_load_fn load;
+	unsigned long cols;
+	unsigned long rows;
+	struct grep_file * files;
+	unsigned long nr_files;
+	unsigned long max_files;
+	unsigned long next;		/* first file no worker took */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+bool search_is_art(const char * name)
+{
+	static const char * extensions[] = {
+		".ans", ".asc", ".bin", ".diz", ".ice", ".nfo", ".txt", NULL
+	};
+	const char * ext = strrchr(name, '.');
+	int i;
+
+	if (!ext)
+		return false;
+	for (i = 0; extensions[i]; i++) {
+		if (strcasecmp(ext, extensions[i]) == 0)
+			return true;
+	}
+	return false;
+}
+
+static void grep_add(struct grep * g, char * path)
+{
+	if (g->nr_files == g->max_files) {
+		g->max_files = g->max_files ? g->max_files * 2 : 256;
+		g->files = realloc(g->files,
+				   g->max_files * sizeof(struct grep_file));
+		if (!g->files)
+			error("Could not allocate memory for file list.");
+	}
+	memset(&g->files[g->nr_files], 0, sizeof(struct grep_file));
+	g->files[g->nr_files++].path = path;
+}
+
+static int compare_names(const void * a, const void * b)
+{
+	return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+/* Art files under dir, subdirectories included, in name order.  Links
+   to files are followed but links to directories are not, so a link
+   back up the tree can't send the walk round forever.  */
+static void grep_list(struct grep * g, const char * dir)
+{
+	char ** names = NULL;
+	unsigned long nr_names = 0, max_names = 0, i;
+	struct dirent * de;
+	DIR * d = opendir(dir);
+
+	if (!d)
+		return;
+
+	while ((de = readdir(d))) {
+		if (de->d_name[0] == '.')
+			continue;
+		if (nr_names == max_names) {
+			max_names = max_names ? max_names * 2 : 64;
+			names = realloc(names, max_names * sizeof(char *));
+			if (!names)
+				error("Could not allocate memory for "
+				      "file list.");
+		}
+		names[nr_names] = malloc(strlen(dir) + strlen(de->d_name) + 2);
+		if (!names[nr_names])
+			error("Could not allocate memory for file name.");
+		sprintf(names[nr_names++], "%s/%s", dir, de->d_name);
+	}
+	closedir(d);
+
+	if (nr_names)
+		qsort(names, nr_names, sizeof(char *), compare_names);
+
+	for (i = 0; i < nr_names; i++) {
+		struct stat st;
+		bool link;
+
+		if (lstat(names[i], &st) != 0) {
+			free(names[i]);
+			continue;
+		}
+		link = S_ISLNK(st.st_mode);
+		if (link && stat(names[i], &st) != 0)
+			free(names[i]);
+		else if (S_ISDIR(st.st_mode)) {
+			if (!link)
+				grep_list(g, names[i]);
+			free(names[i]);
+		} else if (S_ISREG(st.st_mode) && search_is_art(names[i]))
+			grep_add(g, names[i]);
+		else
+			free(names[i]);
+	}
+	free(names);
+}
+
+static void grep_file(struct grep * g, struct grep_file * f,
+		      struct edit_buffer * buf)
+{
+	unsigned long max_matches = 0, from = 0, x, y;
+
+	/* Files that can't be read have no matches.  */
+	edit_buffer_clear(buf);
+	if (!g->load(buf, f->path))
+		return;
+
+	while (search_find(buf, g->pattern, from, &x, &y)) {
+		if (f->nr_matches == max_matches) {
+			max_matches = max_matches ? max_matches * 2 : 4;
+			f->matches = realloc(f->matches, max_matches * 2
+					     * sizeof(unsigned long));
+			if (!f->matches)
+				error("Could not allocate memory for matches.");
+		}
+		f->matches[f->nr_matches * 2] = x;
+		f->matches[f->nr_matches * 2 + 1] = y;
+		f->nr_matches++;
+		from = y * buf->width + x + 1;
+	}
+}
+
+static void * grep_worker(void * data)
+{
+	struct grep * g = data;
+	struct edit_buffer * buf = edit_buffer_create(g->cols, g->rows);
+
+	pthread_mutex_lock(&g->lock);
+	while (g->next < g->nr_files) {
+		struct grep_file * f = &g->files[g->next++];
+
+		pthread_mutex_unlock(&g->lock);
+		grep_file(g, f, buf);
+		pthread_mutex_lock(&g->lock);
+
+		f->done = true;
+		pthread_cond_broadcast(&g->cond);
+	}
+	pthread_mutex_unlock(&g->lock);
+
+	edit_buffer_release(buf);
+	return NULL;
+}
+
+/*
+ *	Print path:row:column, counted from 1, for every match of the
+ *	pattern in the art files under dir, read into canvases of cols x
+ *	rows.  Returns the number of matches.
+ */
+unsigned long search_grep(const char * dir, struct search_pattern * pattern,
+			  search_load_fn load, unsigned long cols,
+			  unsigned long rows)
+{
+	pthread_t workers[GREP_MAX_WORKERS];
+	long nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned long nr_workers, nr_matches = 0, i, j;
+	struct grep g;
+
+	memset(&g, 0, sizeof(g));
+	g.pattern = pattern;
+	g.load = load;
+	g.cols = cols;
+	g.rows = rows;
+	pthread_mutex_init(&g.lock, NULL);
+	pthread_cond_init(&g.cond, NULL);
+
+	grep_list(&g, dir);
+
+	nr_workers = nr_cpus < 1 ? 1 : nr_cpus > GREP_MAX_WORKERS
+				       ? GREP_MAX_WORKERS : nr_cpus;
+	if (nr_workers > g.nr_files)
+		nr_workers = g.nr_files;
+	for (i = 0; i < nr_workers; i++) {
+		if (pthread_create(&workers[i], NULL, grep_worker, &g) != 0)
+			error("Could not create search thread.");
+	}
+
+	for (i = 0; i < g.nr_files; i++) {
+		struct grep_file * f = &g.files[i];
+
+		pthread_mutex_lock(&g.lock);
+		while (!f->done)
+			pthread_cond_wait(&g.cond, &g.lock);
+		pthread_mutex_unlock(&g.lock);
+
+		for (j = 0; j < f->nr_matches; j++)
+			printf("%s:%lu:%lu\n", f->path,
+			       f->matches[j * 2 + 1] + 1, f->matches[j * 2] + 1);
+		nr_matches += f->nr_matches;
+		free(f->matches);
+		free(f->path);
+	}
+
+	for (i = 0; i < nr_workers; i++)
+		pthread_join(workers[i], NULL);
+
+	pthread_cond_destroy(&g.cond);
+	pthread_mutex_destroy(&g.lock);
+	free(g.files);
+	return nr_matches;
+}
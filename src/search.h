@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _SEARCH_H
+#define _SEARCH_H 1
+
+#include <stdbool.h>
+
+struct edit_buffer;
+
+/*
+ *	A search pattern is a rectangle of cells, each with a mask of the
+ *	cell bits that have to match (see CHAR_ATTR_TO_INT).  A mask of
+ *	zero matches any cell.  The scan looks for the anchor cell first
+ *	and only checks the rest of the pattern where it is found.
+ */
+
+struct search_pattern {
+	unsigned long width;
+	unsigned long height;
+	unsigned int * cells;
+	unsigned int * masks;
+	unsigned long anchor;		/* index into cells */
+};
+
+/* Glyph, foreground and background bits of a cell.  */
+#define SEARCH_GLYPH	0x00FF
+#define SEARCH_FG	0x0F00
+#define SEARCH_BG	0xF000
+
+struct search_pattern * search_compile(const char *);
+struct search_pattern * search_from_canvas(struct edit_buffer *);
+void search_release(struct search_pattern *);
+
+bool search_find(struct edit_buffer *, struct search_pattern *,
+		 unsigned long, unsigned long *, unsigned long *);
+
+/* Returns false if the file could not be read.  */
+typedef bool (*search_load_fn)(struct edit_buffer *, const char *);
+
+bool search_is_art(const char *);
+unsigned long search_grep(const char *, struct search_pattern *,
+			  search_load_fn, unsigned long, unsigned long);
+
+#endif
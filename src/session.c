@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "input.h"
+#include "session.h"
+
+/*
+ *	Session log format
+ *
+ *	"NDSL", a version byte and the header fields as varints, the file
+ *	name as a length and its bytes, then a stream of records.  Each
+ *	record is a varint type followed by its fields: for a key the
+ *	delay in microseconds since the previous key and the key code, for
+ *	a resize the new size, for the end the hash of the final canvas.
+ */
+
+#define SESSION_MAGIC "NDSL"
+#define SESSION_MAGIC_LEN 4
+#define SESSION_VERSION 1
+
+static void put_varint(FILE * file, unsigned long long value)
+{
+	while (value >= 0x80) {
+		fputc((value & 0x7F) | 0x80, file);
+		value >>= 7;
+	}
+	fputc(value, file);
+}
+
+static bool get_varint(FILE * file, unsigned long long * value)
+{
+	unsigned int shift = 0;
+
+	*value = 0;
+	for (;;) {
+		int ch = fgetc(file);
+		if (ch == EOF || shift > 63)
+			return false;
+
+		*value |= (unsigned long long) (ch & 0x7F) << shift;
+		if (!(ch & 0x80))
+			return true;
+		shift += 7;
+	}
+}
+
+static bool get_ulong(FILE * file, unsigned long * value)
+{
+	unsigned long long v;
+
+	if (!get_varint(file, &v))
+		return false;
+	*value = v;
+	return true;
+}
+
+/*
+ *	Recording
+ */
+
+static FILE * record_file;
+static unsigned long last_key_time;
+
+bool session_record_open(const char * path, struct session_header * header)
+{
+	record_file = fopen(path, "wb");
+	if (!record_file)
+		return false;
+
+	fwrite(SESSION_MAGIC, 1, SESSION_MAGIC_LEN, record_file);
+	fputc(SESSION_VERSION, record_file);
+
+	put_varint(record_file, header->buf_width);
+	put_varint(record_file, header->buf_height);
+	put_varint(record_file, header->rows);
+	put_varint(record_file, header->cols);
+	put_varint(record_file, header->hash);
+
+	unsigned long len = header->filename ? strlen(header->filename) : 0;
+	put_varint(record_file, len);
+	fwrite(header->filename, 1, len, record_file);
+
+	last_key_time = input_now();
+	return true;
+}
+
+void session_record_key(const struct input_event * event)
+{
+	if (!record_file || event->key == ERR)
+		return;
+
+	unsigned long delay = 0;
+	if (event->timestamp > last_key_time)
+		delay = (event->timestamp - last_key_time) / 1000;
+	last_key_time = event->timestamp;
+
+	put_varint(record_file, SESSION_KEY);
+	put_varint(record_file, delay);
+	put_varint(record_file, event->key);
+}
+
+void session_record_frame(void)
+{
+	if (record_file)
+		put_varint(record_file, SESSION_FRAME);
+}
+
+void session_record_resize(unsigned long rows, unsigned long cols)
+{
+	if (!record_file)
+		return;
+
+	put_varint(record_file, SESSION_RESIZE);
+	put_varint(record_file, rows);
+	put_varint(record_file, cols);
+}
+
+void session_record_close(unsigned long long hash)
+{
+	if (!record_file)
+		return;
+
+	put_varint(record_file, SESSION_END);
+	put_varint(record_file, hash);
+
+	if (fclose(record_file) != 0)
+		error("Could not write session log.");
+	record_file = NULL;
+}
+
+/*
+ *	Replay
+ */
+
+static FILE * replay_file;
+
+bool session_replay_open(const char * path, struct session_header * header)
+{
+	char magic[SESSION_MAGIC_LEN];
+	unsigned long len;
+
+	replay_file = fopen(path, "rb");
+	if (!replay_file)
+		return false;
+
+	if (fread(magic, 1, SESSION_MAGIC_LEN, replay_file) != SESSION_MAGIC_LEN
+	    || memcmp(magic, SESSION_MAGIC, SESSION_MAGIC_LEN) != 0
+	    || fgetc(replay_file) != SESSION_VERSION)
+		goto bad;
+
+	if (!get_ulong(replay_file, &header->buf_width)
+	    || !get_ulong(replay_file, &header->buf_height)
+	    || !get_ulong(replay_file, &header->rows)
+	    || !get_ulong(replay_file, &header->cols)
+	    || !get_varint(replay_file, &header->hash)
+	    || !get_ulong(replay_file, &len))
+		goto bad;
+
+	header->filename = NULL;
+	if (len > 0) {
+		header->filename = malloc(len + 1);
+		if (!header->filename)
+			error("Could not allocate memory for file name.");
+		if (fread(header->filename, 1, len, replay_file) != len)
+			goto bad;
+		header->filename[len] = 0;
+	}
+	return true;
+
+bad:
+	fclose(replay_file);
+	replay_file = NULL;
+	return false;
+}
+
+/* Returns false if the log ends without an end record.  */
+bool session_replay_next(struct session_record * record)
+{
+	unsigned long long type;
+	unsigned long key;
+
+	if (!get_varint(replay_file, &type))
+		return false;
+
+	record->type = type;
+	switch (type) {
+		case SESSION_END:
+			return get_varint(replay_file, &record->hash);
+		case SESSION_FRAME:
+			return true;
+		case SESSION_RESIZE:
+			return get_ulong(replay_file, &record->rows)
+				&& get_ulong(replay_file, &record->cols);
+		case SESSION_KEY:
+			if (!get_ulong(replay_file, &record->delay_us)
+			    || !get_ulong(replay_file, &key))
+				return false;
+			record->key = key;
+			return true;
+	}
+	return false;
+}
+
+void session_replay_close(void)
+{
+	fclose(replay_file);
+	replay_file = NULL;
+}
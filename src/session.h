@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _SESSION_H
+#define _SESSION_H 1
+
+#include <stdbool.h>
+
+struct input_event;
+
+/*
+ *	Session logs record the keys an editing session consumed, the
+ *	points where frames were drawn and terminal resizes, so that the
+ *	session can be replayed without a terminal.
+ */
+
+/* What the session started from.  */
+struct session_header {
+	unsigned long buf_width;
+	unsigned long buf_height;
+	unsigned long rows;		/* full screen size */
+	unsigned long cols;
+	unsigned long long hash;	/* of the initial canvas */
+	char * filename;		/* NULL if none */
+};
+
+enum session_record_type {
+	SESSION_END,
+	SESSION_FRAME,
+	SESSION_RESIZE,
+	SESSION_KEY
+};
+
+struct session_record {
+	enum session_record_type type;
+	int key;
+	unsigned long delay_us;		/* since the previous key */
+	unsigned long rows;
+	unsigned long cols;
+	unsigned long long hash;	/* of the final canvas */
+};
+
+bool session_record_open(const char *, struct session_header *);
+void session_record_key(const struct input_event *);
+void session_record_frame(void);
+void session_record_resize(unsigned long, unsigned long);
+void session_record_close(unsigned long long);
+
+bool session_replay_open(const char *, struct session_header *);
+bool session_replay_next(struct session_record *);
+void session_replay_close(void);
+
+#endif
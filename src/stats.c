@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "colors.h"
+#include "screen.h"
+#include "stats.h"
+
+/*
+ *	Editor instrumentation
+ *
+ *	Span durations go into log-linear histograms: every power of two
+ *	is split into eight buckets, so a percentile is off by at most an
+ *	eighth.  Each span has a histogram for the whole session and one
+ *	for the current window, which the overlay shows before starting
+ *	over.
+ */
+
+bool stats_enabled = false;
+
+#define SUB_BUCKET_BITS 3
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define NR_BUCKETS (64 * SUB_BUCKETS)
+
+struct histogram {
+	unsigned long count;
+	unsigned long sum;
+	unsigned long max;
+	unsigned long buckets[NR_BUCKETS];
+};
+
+struct counters {
+	unsigned long frames;
+	unsigned long cells_drawn;
+	unsigned long bytes_out;
+};
+
+static struct histogram session[NR_STATS_SPANS];
+static struct histogram window[NR_STATS_SPANS];
+
+static struct counters session_counters;
+static struct counters window_counters;
+
+static const char * span_names[NR_STATS_SPANS] = {
+	[STATS_INPUT]		= "input",
+	[STATS_DISPATCH]	= "dispatch",
+	[STATS_DRAW]		= "draw",
+	[STATS_STATUS]		= "status",
+	[STATS_REFRESH]		= "refresh",
+	[STATS_FRAME]		= "frame",
+	[STATS_LATENCY]		= "latency"
+};
+
+static unsigned int bucket_of(unsigned long ns)
+{
+	if (ns < SUB_BUCKETS)
+		return ns;
+
+	int msb = 63 - __builtin_clzl(ns);
+
+	return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS
+		+ ((ns >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+}
+
+static unsigned long bucket_low(unsigned int bucket)
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	int msb = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+	unsigned long sub = bucket % SUB_BUCKETS;
+
+	return (1UL << msb) | (sub << (msb - SUB_BUCKET_BITS));
+}
+
+static unsigned long bucket_mid(unsigned int bucket)
+{
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	return (bucket_low(bucket) + bucket_low(bucket + 1)) / 2;
+}
+
+static void histogram_add(struct histogram * h, unsigned long ns)
+{
+	h->count++;
+	h->sum += ns;
+	if (ns > h->max)
+		h->max = ns;
+	h->buckets[bucket_of(ns)]++;
+}
+
+static unsigned long percentile(struct histogram * h, unsigned int pct)
+{
+	unsigned long target = (h->count * pct + 99) / 100;
+	unsigned long seen = 0;
+	unsigned int i;
+
+	if (h->count == 0)
+		return 0;
+
+	for (i = 0; i < NR_BUCKETS; i++) {
+		seen += h->buckets[i];
+		if (seen >= target)
+			break;
+	}
+
+	unsigned long mid = bucket_mid(i);
+	return mid < h->max ? mid : h->max;
+}
+
+void stats_record(enum stats_span span, unsigned long ns)
+{
+	histogram_add(&session[span], ns);
+	histogram_add(&window[span], ns);
+}
+
+/* Called after every frame whether enabled or not to keep the screen
+   counters in step.  */
+void stats_frame_done(void)
+{
+	static unsigned long last_cells;
+	static unsigned long last_bytes;
+
+	unsigned long cells = screen_stats.cells_drawn - last_cells;
+	unsigned long bytes = screen_stats.bytes_out - last_bytes;
+
+	last_cells = screen_stats.cells_drawn;
+	last_bytes = screen_stats.bytes_out;
+
+	if (!stats_enabled)
+		return;
+
+	session_counters.frames++;
+	session_counters.cells_drawn += cells;
+	session_counters.bytes_out += bytes;
+
+	window_counters.frames++;
+	window_counters.cells_drawn += cells;
+	window_counters.bytes_out += bytes;
+}
+
+/*
+ *	Overlay
+ */
+
+#define OVERLAY_WIDTH 30
+#define NR_OVERLAY_LINES (NR_STATS_SPANS + 3)
+
+#define OVERLAY_ATTR COLOR_ATTR(15, 4)
+
+static char overlay[NR_OVERLAY_LINES][OVERLAY_WIDTH + 1];
+
+static unsigned long per_frame(unsigned long total, unsigned long frames)
+{
+	return frames ? total / frames : 0;
+}
+
+/* Format the overlay from the window that just ended.  */
+void stats_roll_window(void)
+{
+	int i, line = 0;
+
+	snprintf(overlay[line++], OVERLAY_WIDTH + 1,
+		 " %-9s %8s %8s ", "span", "p50 us", "p99 us");
+
+	for (i = 0; i < NR_STATS_SPANS; i++) {
+		struct histogram * h = &window[i];
+
+		snprintf(overlay[line++], OVERLAY_WIDTH + 1,
+			 " %-9s %8.1f %8.1f ", span_names[i],
+			 percentile(h, 50) / 1000.0,
+			 percentile(h, 99) / 1000.0);
+	}
+
+	snprintf(overlay[line++], OVERLAY_WIDTH + 1,
+		 " frames %-21lu ", window_counters.frames);
+	snprintf(overlay[line++], OVERLAY_WIDTH + 1,
+		 " cells/fr %-5lu bytes/fr %-5lu",
+		 per_frame(window_counters.cells_drawn, window_counters.frames),
+		 per_frame(window_counters.bytes_out, window_counters.frames));
+
+	memset(window, 0, sizeof(window));
+	memset(&window_counters, 0, sizeof(window_counters));
+}
+
+/* Drawn over the top right corner of the canvas.  */
+void stats_draw_overlay(struct screen * scr)
+{
+	int i;
+
+	if (scr->width < OVERLAY_WIDTH)
+		return;
+
+	for (i = 0; i < NR_OVERLAY_LINES && i < scr->height; i++)
+		screen_draw_text(scr, i, scr->width - OVERLAY_WIDTH,
+				 OVERLAY_ATTR, overlay[i], OVERLAY_WIDTH);
+}
+
+/*
+ *	Dump
+ */
+
+static void dump_histogram(FILE * file, const char * name,
+			   struct histogram * h)
+{
+	unsigned int i;
+
+	fprintf(file, "\nhistogram %s\n", name);
+	for (i = 0; i < NR_BUCKETS; i++) {
+		if (h->buckets[i])
+			fprintf(file, "%12lu %10lu\n",
+				bucket_low(i), h->buckets[i]);
+	}
+}
+
+/* Write the session totals and histograms (bucket lower bounds in
+   nanoseconds) to the given file.  */
+bool stats_dump(const char * path)
+{
+	FILE * file = fopen(path, "w");
+	int i;
+
+	if (!file)
+		return false;
+
+	struct counters * c = &session_counters;
+
+	fprintf(file, "frames %lu\n", c->frames);
+	fprintf(file, "cells_drawn %lu (%lu per frame)\n",
+		c->cells_drawn, per_frame(c->cells_drawn, c->frames));
+	fprintf(file, "bytes_out %lu (%lu per frame)\n",
+		c->bytes_out, per_frame(c->bytes_out, c->frames));
+
+	fprintf(file, "\n%-9s %10s %10s %10s %10s %10s %10s\n", "span",
+		"count", "mean us", "p50 us", "p90 us", "p99 us", "max us");
+	for (i = 0; i < NR_STATS_SPANS; i++) {
+		struct histogram * h = &session[i];
+
+		fprintf(file, "%-9s %10lu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+			span_names[i], h->count,
+			h->count ? h->sum / h->count / 1000.0 : 0.0,
+			percentile(h, 50) / 1000.0,
+			percentile(h, 90) / 1000.0,
+			percentile(h, 99) / 1000.0,
+			h->max / 1000.0);
+	}
+
+	for (i = 0; i < NR_STATS_SPANS; i++) {
+		if (session[i].count)
+			dump_histogram(file, span_names[i], &session[i]);
+	}
+
+	return fclose(file) == 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _STATS_H
+#define _STATS_H 1
+
+#include <stdbool.h>
+#include <time.h>
+
+struct screen;
+
+/* Timed sections of the editor loop.  */
+enum stats_span {
+	STATS_INPUT,		/* taking events off the ring or decoding keys */
+	STATS_DISPATCH,		/* running the command for one key */
+	STATS_DRAW,		/* screen_draw_edit_buffer() */
+	STATS_STATUS,		/* screen_print_status() */
+	STATS_REFRESH,		/* screen_move() and screen_refresh() */
+	STATS_FRAME,		/* everything above for one frame */
+	STATS_LATENCY,		/* oldest key of a frame to end of refresh */
+	NR_STATS_SPANS
+};
+
+/*
+ *	Instrumentation is always compiled in.  While disabled a span costs
+ *	a test of stats_enabled and no clock reads.
+ */
+extern bool stats_enabled;
+
+static inline unsigned long stats_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+void stats_record(enum stats_span, unsigned long);
+
+static inline unsigned long stats_begin(void)
+{
+	return stats_enabled ? stats_now() : 0;
+}
+
+static inline void stats_end(enum stats_span span, unsigned long start)
+{
+	/* Spans that began before stats were enabled are dropped.  */
+	if (stats_enabled && start)
+		stats_record(span, stats_now() - start);
+}
+
+void stats_frame_done(void);
+void stats_roll_window(void);
+void stats_draw_overlay(struct screen *);
+bool stats_dump(const char *);
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "colors.h"
+#include "cp437.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "utf8-export.h"
+
+/*
+ *	UTF-8 export
+ *
+ *	Writes the canvas as UTF-8 text with SGR color sequences, for any
+ *	terminal rather than one switched to CP437.  High intensity colors
+ *	use the aixterm codes 90-97 and 100-107 instead of bold, or the
+ *	exact VGA palette as 24-bit colors if asked to.  A sequence sets
+ *	only the colors that change, blanks don't change the foreground,
+ *	and every line ends with the colors reset so that the text can be
+ *	paged or cut.
+ */
+
+#define DEFAULT_FG 7
+#define DEFAULT_BG 0
+#define NO_COLOR 16			/* not known to be any color */
+
+/* Longest a cell and a line end can take.  */
+#define MAX_CELL_BYTES (sizeof("\x1b[38;2;255;255;255;48;2;255;255;255m") \
+			+ 3)
+#define MAX_LINE_END_BYTES sizeof("\x1b[0m\n")
+
+#define UTF8_BUFFER_SIZE 65536
+
+struct sgr_code {
+	char bytes[20];
+	unsigned int len;
+};
+
+/* Parameters for each color, indexed by truecolor.  */
+static struct sgr_code fg_codes[2][16];
+static struct sgr_code bg_codes[2][16];
+static bool codes_built = false;
+
+static void build_codes(void)
+{
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		const unsigned char * rgb = vga_palette[i];
+
+		fg_codes[0][i].len = sprintf(fg_codes[0][i].bytes, "%d",
+					     i < 8 ? 30 + i : 90 + i - 8);
+		bg_codes[0][i].len = sprintf(bg_codes[0][i].bytes, "%d",
+					     i < 8 ? 40 + i : 100 + i - 8);
+		fg_codes[1][i].len = sprintf(fg_codes[1][i].bytes,
+					     "38;2;%d;%d;%d",
+					     rgb[0], rgb[1], rgb[2]);
+		bg_codes[1][i].len = sprintf(bg_codes[1][i].bytes,
+					     "48;2;%d;%d;%d",
+					     rgb[0], rgb[1], rgb[2]);
+	}
+	codes_built = true;
+}
+
+static bool is_blank(unsigned int cell)
+{
+	return (cell & 0xff) == ' ' || (cell & 0xff) == 0
+		|| (cell & 0xff) == 0xff;
+}
+
+/* Trailing blanks on black are left out.  */
+static unsigned long row_length(struct edit_buffer * buf, unsigned long y)
+{
+	const unsigned int * row = &buf->buffer[y * buf->width];
+	unsigned long len = buf->width;
+
+	while (len > 0 && is_blank(row[len - 1])
+	       && (row[len - 1] & 0xf000) == 0)
+		len--;
+	return len;
+}
+
+/* Encode row y into out, which has room for it.  Returns its length.  */
+static unsigned long encode_row(char * out, struct edit_buffer * buf,
+				unsigned long y, bool truecolor)
+{
+	const struct cp437_glyph * glyphs = cp437_utf8_glyphs();
+	const struct sgr_code * fgs = fg_codes[truecolor];
+	const struct sgr_code * bgs = bg_codes[truecolor];
+	const unsigned int * row = &buf->buffer[y * buf->width];
+	unsigned long len = row_length(buf, y);
+	/* The terminal's own colors need not be the VGA ones.  */
+	unsigned int fg = truecolor ? NO_COLOR : DEFAULT_FG;
+	unsigned int bg = truecolor ? NO_COLOR : DEFAULT_BG;
+	char * p = out;
+	unsigned long x;
+
+	for (x = 0; x < len; x++) {
+		unsigned int cell = row[x];
+		unsigned int cell_fg = (cell >> 8) & 0x0f;
+		unsigned int cell_bg = (cell >> 12) & 0x0f;
+		const struct cp437_glyph * glyph = &glyphs[cell & 0xff];
+
+		if (is_blank(cell) && fg != NO_COLOR)
+			cell_fg = fg;
+
+		if (cell_fg != fg || cell_bg != bg) {
+			*p++ = '\x1b';
+			*p++ = '[';
+			if (cell_fg != fg) {
+				memcpy(p, fgs[cell_fg].bytes, fgs[cell_fg].len);
+				p += fgs[cell_fg].len;
+			}
+			if (cell_fg != fg && cell_bg != bg)
+				*p++ = ';';
+			if (cell_bg != bg) {
+				memcpy(p, bgs[cell_bg].bytes, bgs[cell_bg].len);
+				p += bgs[cell_bg].len;
+			}
+			*p++ = 'm';
+			fg = cell_fg;
+			bg = cell_bg;
+		}
+		memcpy(p, glyph->bytes, glyph->len);
+		p += glyph->len;
+	}
+
+	if (fg != (truecolor ? NO_COLOR : DEFAULT_FG)
+	    || bg != (truecolor ? NO_COLOR : DEFAULT_BG)) {
+		memcpy(p, "\x1b[0m", 4);
+		p += 4;
+	}
+	*p++ = '\n';
+	return p - out;
+}
+
+/*
+ *	Rows are encoded one after another into a single buffer, which is
+ *	written out when the next row might not fit.
+ */
+bool utf8_export(FILE * output, struct edit_buffer * buf, bool truecolor)
+{
+	unsigned long row_max = buf->width * MAX_CELL_BYTES
+				+ MAX_LINE_END_BYTES;
+	unsigned long size = UTF8_BUFFER_SIZE > row_max ? UTF8_BUFFER_SIZE
+							: row_max;
+	char * out = malloc(size);
+	unsigned long len = 0, y;
+	bool ok = true;
+
+	if (!out)
+		error("Could not allocate memory for UTF-8 export.");
+
+	if (!codes_built)
+		build_codes();
+
+	for (y = 0; ok && y < buf->max_height; y++) {
+		if (size - len < row_max) {
+			ok = fwrite(out, len, 1, output) == 1;
+			len = 0;
+		}
+		len += encode_row(out + len, buf, y, truecolor);
+	}
+	if (ok && len)
+		ok = fwrite(out, len, 1, output) == 1;
+
+	free(out);
+	return ok && fflush(output) == 0 && !ferror(output);
+}
@@ -0,0 +1,1054 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <curses.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "animation.h"
+#include "ansi-esc.h"
+#include "cell-diff.h"
+#include "colors.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "event-loop.h"
+#include "input.h"
+#include "keymap.h"
+#include "screen.h"
+#include "viewer.h"
+
+/*
+ *	Viewer
+ *
+ *	Shows ANSI files of any length without loading them.  Only a window
+ *	of rows around the screen is kept, read from the nearest checkpoint
+ *	whenever the screen moves out of it.  The checkpoints are kept in
+ *	an index file next to the file, so opening it again reads no more
+ *	than a window.
+ */
+
+#define VIEW_WIDTH 80
+#define WINDOW_SCREENS 3	/* window height in screens */
+
+#define STATUS_ATTR COLOR_ATTR(7, 0)
+
+struct viewer {
+	const char * filename;
+	FILE * input;
+	struct ans_index index;
+	struct edit_buffer * window;	/* file rows base onwards */
+	struct screen * scr;
+	unsigned long base;
+	unsigned long top;		/* file row at the top of the screen */
+	bool loaded;
+	bool quit;
+	bool dirty;
+};
+
+static unsigned long last_top(struct viewer * v)
+{
+	if (v->index.nr_rows > v->scr->height)
+		return v->index.nr_rows - v->scr->height;
+	return 0;
+}
+
+static void view_alloc_window(struct viewer * v)
+{
+	if (v->window)
+		edit_buffer_release(v->window);
+
+	v->window = edit_buffer_create(VIEW_WIDTH,
+				       v->scr->height * WINDOW_SCREENS);
+	v->loaded = false;
+}
+
+/* Read a new window if the screen is not inside the current one.  */
+static void view_fill(struct viewer * v)
+{
+	if (v->top > last_top(v))
+		v->top = last_top(v);
+
+	if (v->loaded && v->top >= v->base
+	    && v->top + v->scr->height <= v->base + v->window->height)
+		return;
+
+	/* Leave a screen of rows above for scrolling back.  */
+	v->base = v->top > v->scr->height ? v->top - v->scr->height : 0;
+	ans_read_rows(v->input, v->window, &v->index, v->base);
+	v->loaded = true;
+}
+
+static void view_draw(struct viewer * v)
+{
+	unsigned long bottom = v->top + v->scr->height;
+	char status[128];
+
+	view_fill(v);
+	v->window->start_x = 0;
+	v->window->start_y = v->top - v->base;
+	screen_draw_edit_buffer(v->scr, v->window);
+
+	if (bottom > v->index.nr_rows)
+		bottom = v->index.nr_rows;
+	snprintf(status, sizeof(status), " rows %lu-%lu of %lu  %s",
+		 v->top + 1, bottom, v->index.nr_rows, v->filename);
+	screen_draw_text(v->scr, v->scr->height, 0, STATUS_ATTR, status,
+			 v->scr->width);
+
+	screen_move(0, 0);
+	screen_refresh();
+}
+
+/*
+ *	Commands
+ *
+ *	The viewer follows the keymap for the editor commands that make
+ *	sense when only looking at a file.
+ */
+
+static void view_up(struct viewer * v)
+{
+	if (v->top > 0)
+		v->top--;
+}
+
+static void view_down(struct viewer * v)
+{
+	v->top++;
+}
+
+static void view_page_up(struct viewer * v)
+{
+	v->top = v->top > v->scr->height ? v->top - v->scr->height : 0;
+}
+
+static void view_page_down(struct viewer * v)
+{
+	v->top += v->scr->height;
+}
+
+static void view_start(struct viewer * v)
+{
+	v->top = 0;
+}
+
+static void view_end(struct viewer * v)
+{
+	v->top = last_top(v);
+}
+
+static void view_quit(struct viewer * v)
+{
+	v->quit = true;
+}
+
+static void view_resize(void * data)
+{
+	struct viewer * v = data;
+
+	screen_resize(v->scr);
+	view_alloc_window(v);
+	screen_redraw();
+	v->dirty = true;
+}
+
+static void view_resize_key(struct viewer * v)
+{
+	view_resize(v);
+}
+
+static void view_goto(struct viewer * v)
+{
+	char * answer = screen_prompt(v->scr, "Go to row:");
+
+	if (answer) {
+		unsigned long row = strtoul(answer, NULL, 10);
+
+		v->top = row > 0 ? row - 1 : 0;
+		free(answer);
+	}
+	screen_redraw();
+}
+
+static const struct {
+	const char * command;
+	void (*fn)(struct viewer *);
+} view_commands[] = {
+	{ "move_up",		view_up },
+	{ "move_down",		view_down },
+	{ "page_up",		view_page_up },
+	{ "page_down",		view_page_down },
+	{ "move_to_start",	view_start },
+	{ "move_to_end",	view_end },
+	{ "resize",		view_resize_key },
+	{ "quit",		view_quit }
+};
+
+#define NR_VIEW_COMMANDS (sizeof(view_commands) / sizeof(view_commands[0]))
+
+static void view_key(struct viewer * v, int key)
+{
+	const char * name = keymap_lookup(key)->name;
+	unsigned long i;
+
+	if (key == ERR)
+		error("Could not read key from terminal.");
+
+	if (key == KEY_META('g') || key == KEY_META('G')) {
+		view_goto(v);
+		return;
+	}
+
+	for (i = 0; i < NR_VIEW_COMMANDS; i++) {
+		if (strcmp(view_commands[i].command, name) == 0) {
+			view_commands[i].fn(v);
+			return;
+		}
+	}
+}
+
+static void view_input(int fd, short revents, void * data)
+{
+	struct viewer * v = data;
+	struct input_event event;
+	bool got_key = false;
+
+	while (!v->quit && input_poll()) {
+		while (!v->quit && input_next_event(&event))
+			view_key(v, event.key);
+		got_key = true;
+	}
+
+	if (!got_key && (revents & (POLLERR | POLLHUP)))
+		error("Could not read key from terminal.");
+
+	v->dirty = true;
+}
+
+int view_file(const char * filename, const struct screen_backend * backend,
+	      enum screen_charset charset)
+{
+	struct viewer v;
+
+	memset(&v, 0, sizeof(v));
+	v.filename = filename;
+	v.input = fopen(filename, "rb");
+	if (!v.input) {
+		fprintf(stderr, "Could not open '%s'.\n", filename);
+		return EXIT_FAILURE;
+	}
+	ans_index_open(v.input, filename, &v.index);
+
+	/* Before the screen so that the event loop gets SIGWINCH.  */
+	event_loop_init();
+
+	v.scr = screen_init(backend, charset, VIEW_WIDTH);
+	view_alloc_window(&v);
+
+	input_start();
+	event_loop_watch_fd(input_fd(), view_input, &v);
+	event_loop_on_resize(view_resize, &v);
+
+	v.dirty = true;
+	while (!v.quit) {
+		if (v.dirty) {
+			view_draw(&v);
+			v.dirty = false;
+		}
+		event_loop_run_once();
+	}
+
+	event_loop_on_resize(NULL, NULL);
+	event_loop_unwatch_fd(input_fd());
+	input_stop();
+
+	edit_buffer_release(v.window);
+	screen_release(v.scr);
+	event_loop_release();
+	ans_index_release(&v.index);
+	fclose(v.input);
+
+	return EXIT_SUCCESS;
+}
+
+/*
+ *	Diff viewer
+ *
+ *	Shows two canvases side by side with the cells that differ in
+ *	reverse video and the rows that differ marked in the gutter between
+ *	them.  'n' and 'p' step through the changed rectangles.
+ */
+
+#define GUTTER_ATTR	COLOR_ATTR(8, 0)
+#define CHANGED_ATTR	COLOR_ATTR(14, 0)
+
+struct diff_viewer {
+	struct edit_buffer * a;
+	struct edit_buffer * b;
+	struct cell_diff * diff;
+	const char * name_a;
+	const char * name_b;
+	struct screen * scr;
+	unsigned int * row;		/* one screen row */
+	unsigned long nr_rows;
+	unsigned long top;
+	unsigned long left;		/* first canvas column shown */
+	unsigned long current;		/* rectangle, or nr_rects if none */
+	bool quit;
+	bool dirty;
+};
+
+static unsigned long pane_width(struct diff_viewer * v)
+{
+	unsigned long width = v->scr->width > 1 ? (v->scr->width - 1) / 2 : 0;
+
+	return width < v->a->width ? width : v->a->width;
+}
+
+static unsigned int highlight(unsigned int cell)
+{
+	unsigned int fg = (cell >> 12) & 0x0f;
+	unsigned int bg = (cell >> 8) & 0x07;
+
+	if (fg == bg)
+		fg = bg ^ 0x0f;
+	return CHAR_ATTR_TO_INT(COLOR_ATTR(fg, bg), cell & 0xff);
+}
+
+static void diff_draw_row(struct diff_viewer * v, unsigned long y)
+{
+	unsigned long width = pane_width(v), r = v->top + y, x;
+	unsigned int blank = CHAR_ATTR_TO_INT(COLOR_ATTR(7, 0), ' ');
+	unsigned int * left = v->row, * right = v->row + width + 1;
+	bool changed = false;
+
+	for (x = 0; x < v->scr->width; x++)
+		v->row[x] = blank;
+
+	if (r < v->nr_rows) {
+		const unsigned int * row_a = &v->a->buffer[r * v->a->width];
+		const unsigned int * row_b = &v->b->buffer[r * v->b->width];
+
+		changed = cell_diff_first(row_a, row_b, 0, v->a->width)
+			  < v->a->width;
+
+		for (x = 0; x < width && v->left + x < v->a->width; x++) {
+			unsigned int ca = row_a[v->left + x];
+			unsigned int cb = row_b[v->left + x];
+
+			left[x] = ca == cb ? ca : highlight(ca);
+			right[x] = ca == cb ? cb : highlight(cb);
+		}
+	}
+
+	v->row[width] = changed ? CHAR_ATTR_TO_INT(CHANGED_ATTR, 186)
+				: CHAR_ATTR_TO_INT(GUTTER_ATTR, 179);
+	screen_draw_cells(v->scr, y, 0, v->row, v->scr->width);
+}
+
+static void diff_draw(struct diff_viewer * v)
+{
+	unsigned long bottom = v->top + v->scr->height, y;
+	char status[256], change[64];
+
+	for (y = 0; y < v->scr->height; y++)
+		diff_draw_row(v, y);
+
+	if (bottom > v->nr_rows)
+		bottom = v->nr_rows;
+	if (v->current < v->diff->nr_rects)
+		snprintf(change, sizeof(change), "change %lu of %lu",
+			 v->current + 1, v->diff->nr_rects);
+	else
+		snprintf(change, sizeof(change), "%lu changes",
+			 v->diff->nr_rects);
+	snprintf(status, sizeof(status), " rows %lu-%lu of %lu  %s  %s | %s",
+		 v->top + 1, bottom, v->nr_rows, change, v->name_a, v->name_b);
+	screen_draw_text(v->scr, v->scr->height, 0, STATUS_ATTR, status,
+			 v->scr->width);
+
+	screen_move(0, 0);
+	screen_refresh();
+}
+
+static void diff_scroll(struct diff_viewer * v, unsigned long top)
+{
+	unsigned long last = v->nr_rows > v->scr->height
+			     ? v->nr_rows - v->scr->height : 0;
+
+	v->top = top < last ? top : last;
+}
+
+/* Bring rectangle i into view with a couple of rows above it.  */
+static void diff_show_rect(struct diff_viewer * v, unsigned long i)
+{
+	struct diff_rect * rect = &v->diff->rects[i];
+	unsigned long width = pane_width(v);
+
+	v->current = i;
+	diff_scroll(v, rect->y > 2 ? rect->y - 2 : 0);
+	if (rect->x < v->left || rect->x + rect->width > v->left + width)
+		v->left = rect->x + rect->width > width
+			  ? rect->x + rect->width - width : 0;
+	if (rect->x < v->left)
+		v->left = rect->x;
+}
+
+static void diff_up(struct diff_viewer * v)
+{
+	if (v->top > 0)
+		v->top--;
+}
+
+static void diff_down(struct diff_viewer * v)
+{
+	diff_scroll(v, v->top + 1);
+}
+
+static void diff_page_up(struct diff_viewer * v)
+{
+	v->top = v->top > v->scr->height ? v->top - v->scr->height : 0;
+}
+
+static void diff_page_down(struct diff_viewer * v)
+{
+	diff_scroll(v, v->top + v->scr->height);
+}
+
+static void diff_start(struct diff_viewer * v)
+{
+	v->top = 0;
+}
+
+static void diff_end(struct diff_viewer * v)
+{
+	diff_scroll(v, ULONG_MAX);
+}
+
+static void diff_left(struct diff_viewer * v)
+{
+	if (v->left > 0)
+		v->left--;
+}
+
+static void diff_right(struct diff_viewer * v)
+{
+	if (v->left + pane_width(v) < v->a->width)
+		v->left++;
+}
+
+static void diff_quit(struct diff_viewer * v)
+{
+	v->quit = true;
+}
+
+static void diff_resize(void * data)
+{
+	struct diff_viewer * v = data;
+
+	screen_resize(v->scr);
+	free(v->row);
+	v->row = malloc((v->scr->width + 1) * sizeof(unsigned int));
+	if (!v->row)
+		error("Could not allocate memory for diff view.");
+	diff_scroll(v, v->top);
+	if (v->left + pane_width(v) > v->a->width)
+		v->left = v->a->width - pane_width(v);
+	screen_redraw();
+	v->dirty = true;
+}
+
+static void diff_resize_key(struct diff_viewer * v)
+{
+	diff_resize(v);
+}
+
+static const struct {
+	const char * command;
+	void (*fn)(struct diff_viewer *);
+} diff_commands[] = {
+	{ "move_up",		diff_up },
+	{ "move_down",		diff_down },
+	{ "move_left",		diff_left },
+	{ "move_right",		diff_right },
+	{ "page_up",		diff_page_up },
+	{ "page_down",		diff_page_down },
+	{ "move_to_start",	diff_start },
+	{ "move_to_end",	diff_end },
+	{ "resize",		diff_resize_key },
+	{ "quit",		diff_quit }
+};
+
+#define NR_DIFF_COMMANDS (sizeof(diff_commands) / sizeof(diff_commands[0]))
+
+static void diff_key(struct diff_viewer * v, int key)
+{
+	const char * name = keymap_lookup(key)->name;
+	unsigned long nr_rects = v->diff->nr_rects;
+	unsigned long i;
+
+	if (key == ERR)
+		error("Could not read key from terminal.");
+
+	/* Both wrap around.  */
+	if (key == 'n' && nr_rects > 0) {
+		diff_show_rect(v, v->current + 1 < nr_rects
+				  ? v->current + 1 : 0);
+		return;
+	}
+	if (key == 'p' && nr_rects > 0) {
+		diff_show_rect(v, v->current > 0 && v->current < nr_rects
+				  ? v->current - 1 : nr_rects - 1);
+		return;
+	}
+
+	for (i = 0; i < NR_DIFF_COMMANDS; i++) {
+		if (strcmp(diff_commands[i].command, name) == 0) {
+			diff_commands[i].fn(v);
+			return;
+		}
+	}
+}
+
+static void diff_input(int fd, short revents, void * data)
+{
+	struct diff_viewer * v = data;
+	struct input_event event;
+	bool got_key = false;
+
+	while (!v->quit && input_poll()) {
+		while (!v->quit && input_next_event(&event))
+			diff_key(v, event.key);
+		got_key = true;
+	}
+
+	if (!got_key && (revents & (POLLERR | POLLHUP)))
+		error("Could not read key from terminal.");
+
+	v->dirty = true;
+}
+
+/* Show canvases a and b, of the same size, and their differences.  */
+int view_diff(struct edit_buffer * a, struct edit_buffer * b,
+	      struct cell_diff * diff, const char * name_a,
+	      const char * name_b, const struct screen_backend * backend,
+	      enum screen_charset charset)
+{
+	struct diff_viewer v;
+	unsigned long i;
+
+	memset(&v, 0, sizeof(v));
+	v.a = a;
+	v.b = b;
+	v.diff = diff;
+	v.name_a = name_a;
+	v.name_b = name_b;
+	v.current = diff->nr_rects;
+	v.nr_rows = a->max_height > b->max_height ? a->max_height
+						   : b->max_height;
+	for (i = 0; i < diff->nr_rects; i++) {
+		struct diff_rect * rect = &diff->rects[i];
+
+		if (rect->y + rect->height > v.nr_rows)
+			v.nr_rows = rect->y + rect->height;
+	}
+
+	/* Before the screen so that the event loop gets SIGWINCH.  */
+	event_loop_init();
+
+	v.scr = screen_init(backend, charset, ULONG_MAX);
+	v.row = malloc((v.scr->width + 1) * sizeof(unsigned int));
+	if (!v.row)
+		error("Could not allocate memory for diff view.");
+	if (diff->nr_rects > 0)
+		diff_show_rect(&v, 0);
+
+	input_start();
+	event_loop_watch_fd(input_fd(), diff_input, &v);
+	event_loop_on_resize(diff_resize, &v);
+
+	v.dirty = true;
+	while (!v.quit) {
+		if (v.dirty) {
+			diff_draw(&v);
+			v.dirty = false;
+		}
+		event_loop_run_once();
+	}
+
+	event_loop_on_resize(NULL, NULL);
+	event_loop_unwatch_fd(input_fd());
+	input_stop();
+
+	free(v.row);
+	screen_release(v.scr);
+	event_loop_release();
+
+	return EXIT_SUCCESS;
+}
+
+/*
+ *	Player
+ *
+ *	Plays ANSI animations back at the speed they would have come in at
+ *	over a modem of the given baud rate, ten bits to a byte.  The
+ *	position in the file follows the clock rather than counting ticks,
+ *	so playback keeps time however late the timer fires.  Each tick
+ *	that reads new bytes becomes a frame of the animation, and frames
+ *	already seen are shown again from their recorded changes, so going
+ *	back and forth does not read the file again.
+ */
+
+#define PLAY_TICK_MS 20
+#define PLAY_SEEK_SECONDS 5
+
+static const unsigned long baud_rates[] = {
+	300, 1200, 2400, 9600, 14400, 19200, 28800, 38400, 57600, 115200
+};
+
+#define NR_BAUD_RATES (sizeof(baud_rates) / sizeof(baud_rates[0]))
+
+struct player {
+	const char * filename;
+	struct anim * anim;
+	struct screen * scr;
+	struct event_timer timer;
+	unsigned long baud;
+	double position;		/* in bytes */
+	unsigned long last_ns;		/* when position was moved on */
+	unsigned long top;
+	bool playing;
+	bool reverse;
+	bool follow;			/* keep the cursor on the screen */
+	bool quit;
+	bool dirty;
+};
+
+static unsigned long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+static double bytes_per_second(struct player * p)
+{
+	return p->baud / 10.0;
+}
+
+static long last_offset(struct anim * a)
+{
+	return a->frames[a->nr_frames - 1].offset;
+}
+
+/* Read the file up to offset, a tick's worth of bytes to a frame.  */
+static void play_reach(struct player * p, long offset)
+{
+	struct anim * a = p->anim;
+	long step = bytes_per_second(p) * PLAY_TICK_MS / 1000;
+
+	if (step < 1)
+		step = 1;
+
+	while (!a->ended && last_offset(a) < offset) {
+		long end = last_offset(a) + step;
+
+		anim_read(a, end < offset ? end : offset);
+	}
+}
+
+static void play_start(struct player * p, bool playing)
+{
+	if (playing && !p->playing) {
+		p->last_ns = now_ns();
+		event_loop_add_timer(&p->timer, PLAY_TICK_MS, PLAY_TICK_MS);
+	} else if (!playing && p->playing)
+		event_loop_del_timer(&p->timer);
+
+	p->playing = playing;
+	p->follow = p->follow || playing;
+}
+
+/* Show the frame at the position, stopping at either end.  */
+static void play_show(struct player * p)
+{
+	struct anim * a = p->anim;
+
+	if (p->position <= 0) {
+		p->position = 0;
+		if (p->reverse)
+			play_start(p, false);
+	}
+
+	play_reach(p, p->position);
+	if (a->ended && p->position >= last_offset(a)) {
+		p->position = last_offset(a);
+		if (!p->reverse)
+			play_start(p, false);
+	}
+
+	anim_seek(a, anim_frame_at(a, p->position));
+	p->dirty = true;
+}
+
+static void play_tick(struct event_timer * timer)
+{
+	struct player * p = timer->data;
+	unsigned long now = now_ns();
+	double bytes = (now - p->last_ns) / 1e9 * bytes_per_second(p);
+
+	p->last_ns = now;
+	p->position += p->reverse ? -bytes : bytes;
+	play_show(p);
+}
+
+static unsigned long play_last_top(struct player * p)
+{
+	unsigned long rows = p->anim->canvas->height;
+
+	return rows > p->scr->height ? rows - p->scr->height : 0;
+}
+
+static void play_scroll(struct player * p, unsigned long top)
+{
+	p->top = top < play_last_top(p) ? top : play_last_top(p);
+}
+
+static void play_draw(struct player * p)
+{
+	struct anim * a = p->anim;
+	struct anim_frame * frame = &a->frames[a->current];
+	double rate = bytes_per_second(p);
+	const char * state;
+	char status[256];
+
+	if (p->follow && (frame->cursor_y < p->top
+			  || frame->cursor_y >= p->top + p->scr->height))
+		play_scroll(p, frame->cursor_y > p->scr->height / 2
+			       ? frame->cursor_y - p->scr->height / 2 : 0);
+
+	a->canvas->start_x = 0;
+	a->canvas->start_y = p->top;
+	screen_draw_edit_buffer(p->scr, a->canvas);
+
+	if (p->playing)
+		state = p->reverse ? "reverse" : "playing";
+	else if (a->ended && a->current == a->nr_frames - 1)
+		state = "end";
+	else
+		state = "paused";
+	snprintf(status, sizeof(status),
+		 " %.1fs of %.1fs  %lu baud  frame %lu  %s  %s",
+		 p->position / rate, a->size / rate, p->baud, a->current,
+		 state, p->filename);
+	screen_draw_text(p->scr, p->scr->height, 0, STATUS_ATTR, status,
+			 p->scr->width);
+
+	if (frame->cursor_y >= p->top
+	    && frame->cursor_y < p->top + p->scr->height)
+		screen_move(frame->cursor_y - p->top,
+			    frame->cursor_x < p->scr->width
+			    ? frame->cursor_x : p->scr->width - 1);
+	else
+		screen_move(0, 0);
+	screen_refresh();
+}
+
+/*
+ *	Commands
+ *
+ *	Space pauses and plays, r plays backwards, + and - change the baud
+ *	rate and , and . step a frame.  The cursor keys left and right
+ *	jump PLAY_SEEK_SECONDS, the rest scroll.
+ */
+
+static void play_up(struct player * p)
+{
+	p->follow = false;
+	if (p->top > 0)
+		p->top--;
+}
+
+static void play_down(struct player * p)
+{
+	p->follow = false;
+	play_scroll(p, p->top + 1);
+}
+
+static void play_page_up(struct player * p)
+{
+	p->follow = false;
+	p->top = p->top > p->scr->height ? p->top - p->scr->height : 0;
+}
+
+static void play_page_down(struct player * p)
+{
+	p->follow = false;
+	play_scroll(p, p->top + p->scr->height);
+}
+
+static void play_seek(struct player * p, double seconds)
+{
+	p->position += seconds * bytes_per_second(p);
+	p->follow = true;
+	play_show(p);
+}
+
+static void play_back(struct player * p)
+{
+	play_seek(p, -PLAY_SEEK_SECONDS);
+}
+
+static void play_forward(struct player * p)
+{
+	play_seek(p, PLAY_SEEK_SECONDS);
+}
+
+static void play_rewind(struct player * p)
+{
+	p->position = 0;
+	p->follow = true;
+	play_show(p);
+}
+
+static void play_to_end(struct player * p)
+{
+	p->position = p->anim->size;
+	p->follow = true;
+	play_show(p);
+}
+
+static void play_quit(struct player * p)
+{
+	p->quit = true;
+}
+
+static void play_resize(void * data)
+{
+	struct player * p = data;
+
+	screen_resize(p->scr);
+	play_scroll(p, p->top);
+	screen_redraw();
+	p->dirty = true;
+}
+
+static void play_resize_key(struct player * p)
+{
+	play_resize(p);
+}
+
+static void play_pause(struct player * p)
+{
+	struct anim * a = p->anim;
+
+	/* Playing on from the end starts again.  */
+	if (!p->playing && !p->reverse && a->ended
+	    && a->current == a->nr_frames - 1)
+		p->position = 0;
+	play_start(p, !p->playing);
+}
+
+static void play_reverse(struct player * p)
+{
+	p->reverse = !p->reverse;
+	play_start(p, true);
+}
+
+static void play_step(struct player * p, bool back)
+{
+	struct anim * a = p->anim;
+	unsigned long frame = a->current;
+
+	play_start(p, false);
+	if (back && frame > 0)
+		frame--;
+	else if (!back) {
+		if (frame + 1 == a->nr_frames)
+			play_reach(p, last_offset(a) + 1);
+		if (frame + 1 < a->nr_frames)
+			frame++;
+	}
+
+	anim_seek(a, frame);
+	p->position = a->frames[frame].offset;
+	p->follow = true;
+}
+
+/* Next rate up or down from the current one.  */
+static void play_rate(struct player * p, bool up)
+{
+	unsigned long i;
+
+	if (up) {
+		for (i = 0; i < NR_BAUD_RATES; i++) {
+			if (baud_rates[i] > p->baud) {
+				p->baud = baud_rates[i];
+				return;
+			}
+		}
+	} else {
+		for (i = NR_BAUD_RATES; i > 0; i--) {
+			if (baud_rates[i - 1] < p->baud) {
+				p->baud = baud_rates[i - 1];
+				return;
+			}
+		}
+	}
+}
+
+static void play_faster(struct player * p)
+{
+	play_rate(p, true);
+}
+
+static void play_slower(struct player * p)
+{
+	play_rate(p, false);
+}
+
+static void play_step_back(struct player * p)
+{
+	play_step(p, true);
+}
+
+static void play_step_forward(struct player * p)
+{
+	play_step(p, false);
+}
+
+static const struct {
+	const char * command;
+	void (*fn)(struct player *);
+} play_commands[] = {
+	{ "move_up",		play_up },
+	{ "move_down",		play_down },
+	{ "move_left",		play_back },
+	{ "move_right",		play_forward },
+	{ "page_up",		play_page_up },
+	{ "page_down",		play_page_down },
+	{ "move_to_start",	play_rewind },
+	{ "move_to_end",	play_to_end },
+	{ "play_pause",		play_pause },
+	{ "play_reverse",	play_reverse },
+	{ "play_faster",	play_faster },
+	{ "play_slower",	play_slower },
+	{ "step_back",		play_step_back },
+	{ "step_forward",	play_step_forward },
+	{ "resize",		play_resize_key },
+	{ "quit",		play_quit }
+};
+
+#define NR_PLAY_COMMANDS (sizeof(play_commands) / sizeof(play_commands[0]))
+
+static void play_key(struct player * p, int key)
+{
+	const char * name = keymap_lookup(key)->name;
+	unsigned long i;
+
+	if (key == ERR)
+		error("Could not read key from terminal.");
+
+	for (i = 0; i < NR_PLAY_COMMANDS; i++) {
+		if (strcmp(play_commands[i].command, name) == 0) {
+			play_commands[i].fn(p);
+			return;
+		}
+	}
+}
+
+static void play_input(int fd, short revents, void * data)
+{
+	struct player * p = data;
+	struct input_event event;
+	bool got_key = false;
+
+	while (!p->quit && input_poll()) {
+		while (!p->quit && input_next_event(&event))
+			play_key(p, event.key);
+		got_key = true;
+	}
+
+	if (!got_key && (revents & (POLLERR | POLLHUP)))
+		error("Could not read key from terminal.");
+
+	p->dirty = true;
+}
+
+/* Play an animation into a canvas of the given number of rows.  */
+int play_file(const char * filename, const struct screen_backend * backend,
+	      enum screen_charset charset, unsigned long baud,
+	      unsigned long rows)
+{
+	struct player p;
+	struct stat st;
+	FILE * input;
+
+	memset(&p, 0, sizeof(p));
+	p.filename = filename;
+	p.baud = baud;
+	input = fopen(filename, "rb");
+	if (input && (fstat(fileno(input), &st) < 0 || !S_ISREG(st.st_mode))) {
+		fclose(input);
+		input = NULL;
+	}
+	if (!input) {
+		fprintf(stderr, "Could not open '%s'.\n", filename);
+		return EXIT_FAILURE;
+	}
+	p.anim = anim_open(input, VIEW_WIDTH, rows);
+
+	/* Before the screen so that the event loop gets SIGWINCH.  */
+	event_loop_init();
+
+	p.scr = screen_init(backend, charset, VIEW_WIDTH);
+	p.timer.fn = play_tick;
+	p.timer.data = &p;
+
+	input_start();
+	event_loop_watch_fd(input_fd(), play_input, &p);
+	event_loop_on_resize(play_resize, &p);
+	play_start(&p, true);
+
+	p.dirty = true;
+	while (!p.quit) {
+		if (p.dirty) {
+			play_draw(&p);
+			p.dirty = false;
+		}
+		event_loop_run_once();
+	}
+
+	play_start(&p, false);
+	event_loop_on_resize(NULL, NULL);
+	event_loop_unwatch_fd(input_fd());
+	input_stop();
+
+	screen_release(p.scr);
+	event_loop_release();
+	anim_release(p.anim);
+	fclose(input);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _VIEWER_H
+#define _VIEWER_H 1
+
+#include "screen.h"
+
+struct cell_diff;
+struct edit_buffer;
+
+int view_file(const char *, const struct screen_backend *,
+	      enum screen_charset);
+int view_diff(struct edit_buffer *, struct edit_buffer *, struct cell_diff *,
+	      const char *, const char *, const struct screen_backend *,
+	      enum screen_charset);
+int play_file(const char *, const struct screen_backend *,
+	      enum screen_charset, unsigned long, unsigned long);
+
+#endif
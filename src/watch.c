@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ansi-esc.h"
+#include "bin-file.h"
+#include "bytes.h"
+#include "cell-diff.h"
+#include "edit-buffer.h"
+#include "error.h"
+#include "watch.h"
+
+/*
+ *	The directory is watched rather than the file, as most programs
+ *	save by writing a new file and renaming it over the old one.  The
+ *	watch keeps the bytes it last read and the canvas they make, with
+ *	an index of where the ANSI reader can pick up again.  Binary files
+ *	are simply read again whole.
+ */
+
+struct watch {
+	char * path;
+	const char * name;		/* in path */
+	int fd;
+	bool bin;
+	unsigned char * data;
+	unsigned long len;
+	struct ans_index index;
+	struct edit_buffer * old;	/* the file as last brought in */
+	struct edit_buffer * new;
+};
+
+/* Empty files read as no bytes, missing ones fail.  */
+static bool read_file(const char * path, unsigned char ** data,
+		      unsigned long * len)
+{
+	struct stat st;
+
+	if (stat(path, &st) < 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	*len = 0;
+	*data = bytes_read_file(path, len);
+	return *data || st.st_size == 0;
+}
+
+/* Read the file into w->new again from byte changed on, setting row to
+   the first row that may have changed.  Returns false, leaving w->new
+   as it was, if the bytes could not be read.  */
+static bool read_canvas(struct watch * w, long changed, unsigned long * row)
+{
+	FILE * input;
+
+	*row = 0;
+	if (w->len == 0) {
+		ans_index_release(&w->index);
+		edit_buffer_clear(w->new);
+		return true;
+	}
+
+	input = fmemopen(w->data, w->len, "r");
+	if (!input) {
+		/* The index no longer matches the bytes.  */
+		ans_index_release(&w->index);
+		return false;
+	}
+
+	if (w->bin) {
+		edit_buffer_clear(w->new);
+		bin_file_read(input, w->new, w->new->width);
+	} else
+		*row = ans_reread(input, w->new, &w->index, changed);
+
+	fclose(input);
+	return true;
+}
+
+struct watch * watch_start(const char * path, struct edit_buffer * buf)
+{
+	struct watch * w = calloc(1, sizeof(*w));
+	unsigned long row;
+	char * dir;
+
+	if (!w)
+		error("Could not allocate memory for watch.");
+
+	w->path = strdup(path);
+	w->name = strrchr(w->path, '/');
+	w->name = w->name ? w->name + 1 : w->path;
+	w->bin = bin_file_check(path);
+	w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	dir = w->name == w->path ? strdup(".")
+				 : strndup(w->path, w->name - w->path);
+	if (w->fd < 0
+	    || inotify_add_watch(w->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0
+	    || !read_file(path, &w->data, &w->len)) {
+		free(dir);
+		watch_stop(w);
+		return NULL;
+	}
+	free(dir);
+
+	w->new = edit_buffer_create(buf->width, buf->height);
+	edit_buffer_clear(w->new);
+	if (!read_canvas(w, 0, &row)) {
+		watch_stop(w);
+		return NULL;
+	}
+	w->old = edit_buffer_clone(w->new);
+	return w;
+}
+
+void watch_stop(struct watch * w)
+{
+	if (w->fd >= 0)
+		close(w->fd);
+	if (w->old)
+		edit_buffer_release(w->old);
+	if (w->new)
+		edit_buffer_release(w->new);
+	ans_index_release(&w->index);
+	free(w->data);
+	free(w->path);
+	free(w);
+}
+
+int watch_fd(struct watch * w)
+{
+	return w->fd;
+}
+
+/* Did any of the waiting events happen to the file?  */
+static bool file_touched(struct watch * w)
+{
+	char events[4096]
+		__attribute__((aligned(__alignof__(struct inotify_event))));
+	bool touched = false;
+	ssize_t len;
+
+	while ((len = read(w->fd, events, sizeof(events))) > 0) {
+		char * p = events;
+
+		while (p < events + len) {
+			struct inotify_event * event = (void *) p;
+
+			if (event->len && !strcmp(event->name, w->name))
+				touched = true;
+			p += sizeof(*event) + event->len;
+		}
+	}
+	return touched;
+}
+
+/*
+ *	Bring changes to the file into buf.  Cells the change left alone
+ *	keep whatever was drawn on them since.  Returns true if the canvas
+ *	changed.
+ */
+bool watch_reload(struct watch * w, struct edit_buffer * buf)
+{
+	unsigned long changed = 0, row, i, end;
+	unsigned char * data;
+	unsigned long len;
+	bool redraw = false;
+
+	if (!file_touched(w) || !read_file(w->path, &data, &len))
+		return false;
+
+	while (changed < len && changed < w->len
+	       && data[changed] == w->data[changed])
+		changed++;
+	if (changed == len && len == w->len) {
+		free(data);
+		return false;
+	}
+
+	free(w->data);
+	w->data = data;
+	w->len = len;
+	if (!read_canvas(w, changed, &row))
+		return false;
+
+	end = w->new->width * w->new->height;
+	for (i = row * w->new->width; i < end; i++) {
+		i = cell_diff_first(w->old->buffer, w->new->buffer, i, end);
+		if (i == end)
+			break;
+
+		w->old->buffer[i] = w->new->buffer[i];
+		edit_buffer_put(buf, i % buf->width, i / buf->width,
+				w->new->buffer[i]);
+		redraw = true;
+	}
+	w->old->max_height = w->new->max_height;
+	return redraw;
+}
+
+/* A save of our own to path should not come back as a change.  */
+void watch_saved(struct watch * w, const char * path)
+{
+	struct stat saved, watched;
+	unsigned char * data;
+	unsigned long len, row;
+
+	if (stat(path, &saved) < 0 || stat(w->path, &watched) < 0
+	    || saved.st_dev != watched.st_dev || saved.st_ino != watched.st_ino
+	    || !read_file(w->path, &data, &len))
+		return;
+
+	free(w->data);
+	w->data = data;
+	w->len = len;
+	ans_index_release(&w->index);
+	if (!read_canvas(w, 0, &row))
+		return;
+	memcpy(w->old->buffer, w->new->buffer,
+	       w->new->width * w->new->height * sizeof(*w->new->buffer));
+	w->old->max_height = w->new->max_height;
+}
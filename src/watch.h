@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _WATCH_H
+#define _WATCH_H 1
+
+#include <stdbool.h>
+
+struct edit_buffer;
+
+/*
+ *	A watch follows a file on disk while it is being edited and brings
+ *	changes other programs make to it into the canvas.  The file is
+ *	read again only from the first byte that changed, and only the
+ *	cells the change touched are written to the canvas.
+ */
+
+struct watch * watch_start(const char *, struct edit_buffer *);
+void watch_stop(struct watch *);
+int watch_fd(struct watch *);
+bool watch_reload(struct watch *, struct edit_buffer *);
+void watch_saved(struct watch *, const char *);
+
+#endif
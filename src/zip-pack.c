@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "error.h"
+#include "zip-pack.h"
+
+/*
+ *	Central directory
+ *
+ *	Only what art packs use is understood: members that are stored or
+ *	deflated, without encryption or ZIP64 sizes.  Other members are
+ *	left out of the directory.
+ */
+
+#define END_SIGNATURE		0x06054b50
+#define CENTRAL_SIGNATURE	0x02014b50
+#define LOCAL_SIGNATURE		0x04034b50
+
+#define END_RECORD_SIZE		22
+#define CENTRAL_HEADER_SIZE	46
+#define LOCAL_HEADER_SIZE	30
+#define MAX_COMMENT_SIZE	65535
+
+#define METHOD_STORED		0
+#define METHOD_DEFLATED		8
+
+#define FLAG_ENCRYPTED		0x0001
+#define ZIP64_VALUE		0xffffffffUL
+
+static unsigned int get16(const unsigned char * p)
+{
+	return p[0] | p[1] << 8;
+}
+
+static unsigned long get32(const unsigned char * p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (unsigned long) p[3] << 24;
+}
+
+/* The end record is last but for a comment of up to 64 KiB.  */
+static const unsigned char * find_end_record(const unsigned char * map,
+					     unsigned long size)
+{
+	unsigned long i, lowest;
+
+	if (size < END_RECORD_SIZE)
+		return NULL;
+
+	lowest = size > END_RECORD_SIZE + MAX_COMMENT_SIZE
+		 ? size - END_RECORD_SIZE - MAX_COMMENT_SIZE : 0;
+	for (i = size - END_RECORD_SIZE; ; i--) {
+		if (get32(map + i) == END_SIGNATURE)
+			return map + i;
+		if (i == lowest)
+			return NULL;
+	}
+}
+
+static bool read_directory(struct zip_pack * pack)
+{
+	const unsigned char * end = find_end_record(pack->map, pack->size);
+	const unsigned char * p, * dir_end;
+	unsigned long nr, dir_offset, dir_size, i;
+	char * name;
+
+	if (!end)
+		return false;
+
+	nr = get16(end + 10);
+	dir_size = get32(end + 12);
+	dir_offset = get32(end + 16);
+	if (dir_offset > pack->size || dir_size > pack->size - dir_offset)
+		return false;
+
+	/* Names are shorter than the directory they are in.  */
+	pack->members = malloc((nr ? nr : 1) * sizeof(struct zip_member));
+	pack->names = malloc(dir_size + 1);
+	if (!pack->members || !pack->names)
+		error("Could not allocate memory for ZIP directory.");
+
+	p = pack->map + dir_offset;
+	dir_end = p + dir_size;
+	name = pack->names;
+	for (i = 0; i < nr; i++) {
+		struct zip_member * m = &pack->members[pack->nr_members];
+		unsigned int name_len, len;
+
+		if (dir_end - p < CENTRAL_HEADER_SIZE
+		    || get32(p) != CENTRAL_SIGNATURE)
+			return false;
+
+		name_len = get16(p + 28);
+		len = CENTRAL_HEADER_SIZE + name_len + get16(p + 30)
+		      + get16(p + 32);
+		if (dir_end - p < len)
+			return false;
+
+		m->method = get16(p + 10);
+		m->crc = get32(p + 16);
+		m->compressed_size = get32(p + 20);
+		m->size = get32(p + 24);
+		m->header_offset = get32(p + 42);
+
+		if (!(get16(p + 8) & FLAG_ENCRYPTED)
+		    && (m->method == METHOD_STORED
+			|| m->method == METHOD_DEFLATED)
+		    && m->compressed_size != ZIP64_VALUE
+		    && m->size != ZIP64_VALUE
+		    && m->header_offset != ZIP64_VALUE
+		    && name_len > 0
+		    && p[CENTRAL_HEADER_SIZE + name_len - 1] != '/') {
+			memcpy(name, p + CENTRAL_HEADER_SIZE, name_len);
+			name[name_len] = '\0';
+			m->name = name;
+			name += name_len + 1;
+			pack->nr_members++;
+		}
+		p += len;
+	}
+	return true;
+}
+
+static void free_pack(struct zip_pack * pack)
+{
+	if (pack->map)
+		munmap((void *) pack->map, pack->size);
+	free(pack->members);
+	free(pack->names);
+	free(pack->path);
+	free(pack);
+}
+
+static struct zip_pack * read_pack(const char * path, const struct stat * st)
+{
+	struct zip_pack * pack;
+	void * map;
+	int fd;
+
+	if (st->st_size == 0)
+		return NULL;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	map = mmap(NULL, st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	pack = calloc(1, sizeof(struct zip_pack));
+	if (!pack)
+		error("Could not allocate memory for ZIP pack.");
+
+	pack->map = map;
+	pack->size = st->st_size;
+	pack->dev = st->st_dev;
+	pack->ino = st->st_ino;
+	pack->mtime = st->st_mtim;
+	pack->path = strdup(path);
+	if (!pack->path)
+		error("Could not allocate memory for file name.");
+
+	if (!read_directory(pack)) {
+		free_pack(pack);
+		return NULL;
+	}
+	return pack;
+}
+
+/*
+ *	Pack cache
+ *
+ *	Packs are kept most recently opened first.  Those that nobody has
+ *	open are dropped from the end once there are too many.  A pack
+ *	that changed on disk is dropped as soon as it is found out, or
+ *	when its last member is closed if it is in use.
+ *
+ *	The grep and browse workers open packs too, so the cache and the
+ *	user counts are only touched with cache_lock held.  A pack is read
+ *	without it; two threads reading the same one both cache it, and
+ *	the spare copy is dropped like any other.
+ */
+
+#define ZIP_CACHE_SIZE 16
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct zip_pack * cache;
+static unsigned int nr_cached;
+
+static bool same_file(const struct zip_pack * pack, const struct stat * st)
+{
+	return pack->dev == st->st_dev && pack->ino == st->st_ino
+		&& pack->size == st->st_size
+		&& pack->mtime.tv_sec == st->st_mtim.tv_sec
+		&& pack->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+static void uncache(struct zip_pack ** prev)
+{
+	struct zip_pack * pack = *prev;
+
+	*prev = pack->next;
+	pack->next = NULL;
+	pack->cached = false;
+	nr_cached--;
+	if (!pack->users)
+		free_pack(pack);
+}
+
+static void trim_cache(void)
+{
+	while (nr_cached > ZIP_CACHE_SIZE) {
+		struct zip_pack ** prev, ** victim = NULL;
+
+		for (prev = &cache; *prev; prev = &(*prev)->next) {
+			if (!(*prev)->users)
+				victim = prev;
+		}
+		if (!victim)
+			break;
+		uncache(victim);
+	}
+}
+
+/* Returns NULL if the file is not a ZIP file that can be read.  */
+struct zip_pack * zip_pack_open(const char * path)
+{
+	struct zip_pack ** prev, * pack;
+	struct stat st;
+
+	if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+		return NULL;
+
+	pthread_mutex_lock(&cache_lock);
+	for (prev = &cache; *prev; prev = &(*prev)->next) {
+		pack = *prev;
+		if (strcmp(pack->path, path) != 0)
+			continue;
+
+		if (!same_file(pack, &st)) {
+			uncache(prev);
+			break;
+		}
+		*prev = pack->next;
+		pack->next = cache;
+		cache = pack;
+		pack->users++;
+		pthread_mutex_unlock(&cache_lock);
+		return pack;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	pack = read_pack(path, &st);
+	if (!pack)
+		return NULL;
+
+	pthread_mutex_lock(&cache_lock);
+	pack->users = 1;
+	pack->cached = true;
+	pack->next = cache;
+	cache = pack;
+	nr_cached++;
+	trim_cache();
+	pthread_mutex_unlock(&cache_lock);
+	return pack;
+}
+
+void zip_pack_close(struct zip_pack * pack)
+{
+	bool unused;
+
+	pthread_mutex_lock(&cache_lock);
+	unused = --pack->users == 0 && !pack->cached;
+	pthread_mutex_unlock(&cache_lock);
+
+	if (unused)
+		free_pack(pack);
+}
+
+/* Names are matched exactly first, then ignoring case.  */
+const struct zip_member * zip_pack_find(struct zip_pack * pack,
+					const char * name)
+{
+	unsigned long i;
+
+	for (i = 0; i < pack->nr_members; i++) {
+		if (strcmp(pack->members[i].name, name) == 0)
+			return &pack->members[i];
+	}
+	for (i = 0; i < pack->nr_members; i++) {
+		if (strcasecmp(pack->members[i].name, name) == 0)
+			return &pack->members[i];
+	}
+	return NULL;
+}
+
+/*
+ *	Member streams
+ *
+ *	A member is read through a stdio stream so that the ANSI and BIN
+ *	readers take it like any other file.  Deflated data is inflated
+ *	from the mapping as the reader asks for it, and the checksum is
+ *	checked at the end.
+ */
+
+struct member_stream {
+	struct zip_pack * pack;
+	const struct zip_member * member;
+	const unsigned char * data;
+	unsigned long pos;
+	unsigned long out;
+	unsigned long crc;
+	bool done;
+	z_stream z;
+};
+
+static ssize_t member_read(void * cookie, char * buf, size_t len)
+{
+	struct member_stream * s = cookie;
+	const struct zip_member * m = s->member;
+	size_t n;
+	int ret;
+
+	if (s->done || len == 0)
+		return 0;
+
+	if (m->method == METHOD_STORED) {
+		n = m->compressed_size - s->pos;
+		if (n > len)
+			n = len;
+		memcpy(buf, s->data + s->pos, n);
+		s->pos += n;
+		s->done = s->pos == m->compressed_size;
+	} else {
+		s->z.next_out = (Bytef *) buf;
+		s->z.avail_out = len;
+		ret = inflate(&s->z, Z_NO_FLUSH);
+		n = len - s->z.avail_out;
+		if (ret == Z_STREAM_END)
+			s->done = true;
+		else if (ret != Z_OK || (n == 0 && s->z.avail_in == 0)) {
+			errno = EIO;
+			return -1;
+		}
+	}
+
+	s->crc = crc32(s->crc, (const Bytef *) buf, n);
+	s->out += n;
+	if (s->done && (s->crc != m->crc || s->out != m->size)) {
+		errno = EIO;
+		return -1;
+	}
+	return n;
+}
+
+static int member_close(void * cookie)
+{
+	struct member_stream * s = cookie;
+
+	if (s->member->method == METHOD_DEFLATED)
+		inflateEnd(&s->z);
+	zip_pack_close(s->pack);
+	free(s);
+	return 0;
+}
+
+static const cookie_io_functions_t member_functions = {
+	.read	= member_read,
+	.close	= member_close
+};
+
+/* The stream keeps the pack open until it is closed.  */
+FILE * zip_pack_open_member(struct zip_pack * pack,
+			    const struct zip_member * member)
+{
+	const unsigned char * local = pack->map + member->header_offset;
+	struct member_stream * s;
+	unsigned long data_offset;
+	FILE * file;
+
+	if (pack->size < LOCAL_HEADER_SIZE
+	    || member->header_offset > pack->size - LOCAL_HEADER_SIZE
+	    || get32(local) != LOCAL_SIGNATURE)
+		return NULL;
+
+	data_offset = member->header_offset + LOCAL_HEADER_SIZE
+		      + get16(local + 26) + get16(local + 28);
+	if (data_offset > pack->size
+	    || member->compressed_size > pack->size - data_offset)
+		return NULL;
+
+	s = calloc(1, sizeof(struct member_stream));
+	if (!s)
+		error("Could not allocate memory for ZIP member.");
+
+	s->pack = pack;
+	s->member = member;
+	s->data = pack->map + data_offset;
+	s->crc = crc32(0, Z_NULL, 0);
+
+	if (member->method == METHOD_DEFLATED) {
+		s->z.next_in = (Bytef *) s->data;
+		s->z.avail_in = member->compressed_size;
+		/* Raw deflate data, without a zlib header.  */
+		if (inflateInit2(&s->z, -MAX_WBITS) != Z_OK) {
+			free(s);
+			return NULL;
+		}
+	}
+
+	file = fopencookie(s, "r", member_functions);
+	if (!file) {
+		if (member->method == METHOD_DEFLATED)
+			inflateEnd(&s->z);
+		free(s);
+		return NULL;
+	}
+	pthread_mutex_lock(&cache_lock);
+	pack->users++;
+	pthread_mutex_unlock(&cache_lock);
+	return file;
+}
+
+/*
+ *	A member is named by the path of its pack followed by its name in
+ *	the pack, as in packs/acid-0396.zip/CT-ACID.ANS.  Returns the path
+ *	of the pack and points member at the name, or returns NULL if the
+ *	path goes through no pack.
+ */
+char * zip_pack_split_path(const char * path, const char ** member)
+{
+	const char * p = strcasestr(path, ".zip/");
+	char * pack_path;
+
+	if (!p || !p[5])
+		return NULL;
+
+	pack_path = strndup(path, p + 4 - path);
+	if (!pack_path)
+		error("Could not allocate memory for file name.");
+
+	*member = p + 5;
+	return pack_path;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2004  Pekka Enberg <penberg@iki.fi>
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ */
+
+#ifndef _ZIP_PACK_H
+#define _ZIP_PACK_H 1
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <time.h>
+
+/*
+ *	Art packs are ZIP files.  A pack is mapped into memory and its
+ *	central directory read once, and members are read straight out of
+ *	the mapping.  Packs stay cached after they are closed so that
+ *	opening one again costs only a stat().
+ */
+
+struct zip_member {
+	const char * name;
+	unsigned long header_offset;	/* of the local file header */
+	unsigned long compressed_size;
+	unsigned long size;
+	unsigned long crc;
+	unsigned int method;
+};
+
+struct zip_pack {
+	char * path;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+	const unsigned char * map;
+	unsigned long nr_members;
+	struct zip_member * members;
+	char * names;
+	unsigned int users;
+	bool cached;
+	struct zip_pack * next;		/* in the cache */
+};
+
+struct zip_pack * zip_pack_open(const char *);
+void zip_pack_close(struct zip_pack *);
+
+const struct zip_member * zip_pack_find(struct zip_pack *, const char *);
+FILE * zip_pack_open_member(struct zip_pack *, const struct zip_member *);
+
+char * zip_pack_split_path(const char *, const char **);
+
+#endif